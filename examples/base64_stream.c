@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "json.h"
+#include "helpers.h"
+
+// Requires JSON_BASE64, link with ../latin1_utf8_b64.c
+
+// Sink receiving decoded "image" octets
+uint8_t print_octets(uint8_t * data, size_t length, void * user) {
+  size_t n;
+  printf("(%u octets:", (unsigned)length);
+  for(n = 0; n < length; n++) printf(" %02X", data[n]);
+  printf(") ");
+  return JSON_OK;
+}
+
+// Callback requesting Base64 decoding of "image", printing everything
+uint8_t request_image(uint32_t depth, uint8_t type, void * value, void * user) {
+  print_json(depth, type, value, user);
+  if(type == JSON_KEY && !strcmp(json_to_string(value), "image")) return JSON_DECODE_BASE64;
+  return JSON_OK;
+}
+
+int main() {
+  char json[] = "{\"name\":\"blink.bin\",\"image\":\"AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8g\\/w==\",\"size\":34}";
+  uint8_t result;
+  char jsbuf[16]; // Decoding buffer, also the chunk size for decoded octets
+  size_t n;
+
+  printf("Output:\n");
+
+  // Prepare context for streaming, with sink for Base64 values
+  json_parser_ctx ctx = json_stream(jsbuf, sizeof(jsbuf), request_image, NULL);
+  json_base64(&ctx, print_octets);
+
+  // Stream data to json decoder, 7 characters at a time
+  for(n = 0, result = JSON_OK; n < strlen(json) && !result; n += 7) {
+    result = json_block(&ctx, &json[n], strlen(json) - n < 7 ? strlen(json) - n : 7);
+  }
+
+  printf("\nCompletion status: %s\n\n", result_to_string(result));
+}
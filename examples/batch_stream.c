@@ -0,0 +1,35 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "json.h"
+#include "helpers.h"
+
+// Requires JSON_BATCH
+
+// Callback to print a batch of parsed JSON to screen
+uint8_t print_batch(json_event * events, uint16_t count, void * user) {
+  uint16_t n;
+  printf("-- %u events\n", count);
+  for(n = 0; n < count; n++) {
+    print_json(events[n].depth, events[n].type, &events[n].u, user);
+  }
+  return JSON_OK;
+}
+
+int main() {
+  char json[] = "[null,-1.23000456789e+2,false,\"Sing ♪ a \\u266B song\",{\"var\":[0.0,1.500,2,{}]}]";
+  uint8_t result;
+  char jsbuf[64]; // Decoding buffer, holds all strings of a batch
+  json_event events[4];
+
+  printf("Output:\n");
+
+  // Prepare context for streaming, delivering 4 events at a time
+  json_parser_ctx ctx = json_stream(jsbuf, sizeof(jsbuf), NULL, NULL);
+  json_batch(&ctx, events, sizeof(events) / sizeof(events[0]), print_batch);
+
+  // Stream data to json decoder
+  result = json_block(&ctx, json, strlen(json));
+
+  printf("\nCompletion status: %s\n\n", result_to_string(result));
+}
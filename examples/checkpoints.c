@@ -0,0 +1,56 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "json.h"
+#include "helpers.h"
+
+// Requires JSON_CHECKPOINTS
+
+// Write checkpoints to sidecar index file
+uint8_t save_checkpoint(json_checkpoint * checkpoint, void * user) {
+  fwrite(checkpoint, sizeof(json_checkpoint), 1, (FILE *)user);
+  return JSON_OK;
+}
+
+// Print checkpoint offsets
+uint8_t print_checkpoint(json_checkpoint * checkpoint, void * user) {
+  printf("Checkpoint at offset %u\n", (unsigned)checkpoint->offset);
+  return JSON_OK;
+}
+
+int main() {
+  char json[] = "[{\"id\":1,\"name\":\"first\"},{\"id\":2,\"name\":\"second\"},{\"id\":3,\"name\":\"third\"},{\"id\":4,\"name\":\"fourth\"}]";
+  uint8_t result;
+  char jsbuf[32]; // Decoding buffer (minimum size is 5)
+  json_checkpoint checkpoint;
+  FILE *index;
+
+  // Parse once, writing a checkpoint roughly every 32 octets
+  index = fopen("checkpoints.idx", "wb");
+  if(!index) return 1;
+  json_parser_ctx ctx = json_stream(jsbuf, sizeof(jsbuf), NULL, index);
+  json_checkpoints(&ctx, 32, save_checkpoint);
+  result = json_block(&ctx, json, strlen(json));
+  fclose(index);
+  printf("Indexing status: %s\n\n", result_to_string(result));
+
+  // Seek to second checkpoint and parse only what follows it
+  index = fopen("checkpoints.idx", "rb");
+  if(!index) return 1;
+  fseek(index, sizeof(json_checkpoint), SEEK_SET);
+  fread(&checkpoint, sizeof(json_checkpoint), 1, index);
+  fclose(index);
+
+  printf("Output from offset %u:\n", (unsigned)checkpoint.offset);
+  ctx = json_resume(&checkpoint, jsbuf, sizeof(jsbuf), print_json, NULL);
+  result = json_block(&ctx, &json[checkpoint.offset], strlen(json) - checkpoint.offset);
+  if(!result && !json_eof(&ctx)) result = JSON_UNEXPECTED_END;
+
+  printf("\nCompletion status: %s\n\n", result_to_string(result));
+
+  // Checkpoints can also be spaced by records, here every two elements of the top-level array
+  ctx = json_stream(jsbuf, sizeof(jsbuf), NULL, NULL);
+  json_checkpoints_elements(&ctx, 2, print_checkpoint);
+  result = json_block(&ctx, json, strlen(json));
+  printf("Indexing status: %s\n\n", result_to_string(result));
+}
@@ -34,13 +34,19 @@ char * result_to_string(uint8_t result) {
     case JSON_TOO_DEEP            : return "TOO DEEP";
     case JSON_NUMBER_OVERFLOW     : return "NUMBER OVERFLOW";
     case JSON_STRING_OVERFLOW     : return "STRING OVERFLOW";
+    case JSON_BAD_PATH            : return "BAD PATH";
+    case JSON_ARRAY_MISMATCH      : return "ARRAY MISMATCH";
+    case JSON_ARRAY_OVERFLOW      : return "ARRAY OVERFLOW";
+    case JSON_MALFORMED_BASE64    : return "MALFORMED BASE64";
+    case JSON_IMAGE_OVERFLOW      : return "IMAGE OVERFLOW";
+    case JSON_BAD_IMAGE           : return "BAD IMAGE";
   }
   return "UNKNOWN RESULT";
 }
 
 // Allocate and read entire file into memory, zero-terminate
 void *file_to_string(char *filename, size_t *size) {
-  void *data;
+  void *data = NULL;
   FILE *f;
   f = fopen(filename, "rb");
   if(f) {
@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "json.h"
+#include "json_image.h"
+#include "helpers.h"
+
+// Link with ../json_image.c
+
+int main() {
+  char json[] = "{\"cities\":[{\"name\":\"Oslo\",\"pop\":709037,\"lat\":59.91},{\"name\":\"Bergen\",\"pop\":289330,\"lat\":60.39}],\"country\":\"NO\",\"eu\":false}";
+  uint32_t image_buffer[128]; // Built image, would normally be written to a file and mapped later
+  uint32_t stack[32];         // Scratch stack for building
+  json_image_builder builder;
+  json_image image;
+  uint32_t cities, city, n;
+  int64_t population;
+  uint8_t result;
+
+  // Build image from parsing events
+  json_image_begin(&builder, image_buffer, sizeof(image_buffer), stack, sizeof(stack) / sizeof(stack[0]));
+  result = json_parse(json, strlen(json), json_image_callback, &builder);
+  if(!result) result = json_image_end(&builder);
+  printf("Build status: %s (%u octets)\n\n", result_to_string(result), builder.used);
+  if(result) return 1;
+
+  // Load image and query it without parsing
+  result = json_image_load(&image, image_buffer, builder.used);
+  printf("Load status: %s\n", result_to_string(result));
+  if(result) return 1;
+  printf("country: %s\n", json_image_string(&image, json_image_get(&image, image.root, "country", 7)));
+  cities = json_image_get(&image, image.root, "cities", 6);
+  for(n = 0; n < json_image_count(&image, cities); n++) {
+    city = json_image_index(&image, cities, n);
+    json_image_int64(&image, json_image_get(&image, city, "pop", 3), &population);
+    printf("%s: population %lld, latitude %g\n", json_image_string(&image, json_image_get(&image, city, "name", 4)),
+      (long long)population, json_image_double(&image, json_image_get(&image, city, "lat", 3)));
+  }
+  printf("keys:");
+  for(n = 0; n < json_image_count(&image, image.root); n++) printf(" %s", json_image_string(&image, json_image_key(&image, image.root, n)));
+  printf("\n\n");
+}
@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "json.h"
+#include "helpers.h"
+
+// Requires JSON_INTERN
+
+// Callback printing strings with their interned ids
+uint8_t print_ids(uint32_t depth, uint8_t type, void * value, void * user) {
+  json_string *s = (json_string *)value;
+  if(type == JSON_KEY) printf("%s#%u:", json_to_string(value), s->id);
+  else if(type == JSON_STRING) printf("%s#%u ", json_to_string(value), s->id);
+  else if(type == JSON_OBJECT_END) printf("\n");
+  return JSON_OK;
+}
+
+int main() {
+  char json[] = "[{\"status\":\"ok\",\"level\":\"info\"},{\"status\":\"ok\",\"level\":\"warn\"},{\"status\":\"failed\",\"level\":\"info\"}]";
+  uint8_t result;
+  char jsbuf[32];
+  uint32_t arena[64]; // Interned strings stay here after parsing
+  json_intern_table table;
+  uint32_t n;
+
+  printf("Output:\n");
+
+  // Prepare context for streaming, interning up to 8 strings of up to 16 octets
+  json_parser_ctx ctx = json_stream(jsbuf, sizeof(jsbuf), print_ids, NULL);
+  json_intern_init(&table, arena, sizeof(arena), 8, 16);
+  json_intern(&ctx, &table);
+
+  // Stream data to json decoder
+  result = json_block(&ctx, json, strlen(json));
+
+  printf("\nCompletion status: %s\n\n", result_to_string(result));
+
+  printf("Interned strings:\n");
+  for(n = 1; n <= table.count; n++) {
+    json_string s = json_intern_string(&table, n);
+    printf("#%u: %s\n", n, json_to_string(&s));
+  }
+}
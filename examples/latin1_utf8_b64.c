@@ -3,6 +3,12 @@
 
 void main() {
   char str2[256], str1[256];
+  uint8_t n;
+
+  // Base-64 alphabet decodes to its positions
+  for(n = 0; n < 64; n++) {
+    if(base64_value(base64lut[n]) != n) printf("Base-64 value of '%c' is not %u\n", base64lut[n], n);
+  }
   
   // Base-64
   strcpy(str1, "Hello Base-64");
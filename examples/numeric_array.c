@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "json.h"
+#include "helpers.h"
+
+// Requires JSON_ARRAY_CLAIM
+
+double samples[16];
+
+// Callback claiming the "samples" array, printing everything else
+uint8_t claim_samples(uint32_t depth, uint8_t type, void * value, void * user) {
+  static bool is_samples = false;
+  json_array *array = (json_array *)value;
+  uint32_t n;
+  if(type == JSON_KEY) {
+    is_samples = !strcmp(json_to_string(value), "samples");
+  } else if(type == JSON_ARRAY && is_samples) {
+    array->data = samples;
+    array->size = sizeof(samples) / sizeof(samples[0]);
+    array->type = JSON_DOUBLE;
+  } else if(type == JSON_ARRAY_END && array) {
+    for(n = 0; n <= depth; n++) printf("  ");
+    printf("(%u samples:", array->count);
+    for(n = 0; n < array->count; n++) printf(" %g", samples[n]);
+    printf(")\n");
+  }
+  return print_json(depth, type, value, user);
+}
+
+int main() {
+  char json[] = "{\"rate\":100,\"samples\":[1.23,4.56,-7.5e-1,8,0.001],\"tags\":[\"a\",\"b\"]}";
+  uint8_t result;
+
+  printf("Output:\n");
+
+  // Decode JSON in-place (will modify string)
+  result = json_parse(json, strlen(json), claim_samples, NULL);
+
+  printf("\nCompletion status: %s\n\n", result_to_string(result));
+}
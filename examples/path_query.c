@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "json.h"
+#include "json_path.h"
+#include "helpers.h"
+
+const char * const queries[] = {"$.user.id", "$.items[*].price", "$..timestamp", "$.items[1]"};
+
+// Callback to print matches to screen, one event per line
+uint8_t print_match(uint8_t query, uint32_t depth, uint8_t type, void * value, void * user) {
+  printf("%-18s %*s", queries[query], (int)depth * 2, "");
+  switch(type) {
+    case JSON_OBJECT:     printf("{\n"); break;
+    case JSON_OBJECT_END: printf("}\n"); break;
+    case JSON_ARRAY:      printf("[\n"); break;
+    case JSON_ARRAY_END:  printf("]\n"); break;
+    case JSON_KEY:        printf("\"%s\" :\n", json_to_string(value)); break;
+    case JSON_STRING:     printf("\"%s\"\n", json_to_string(value)); break;
+    case JSON_NUMBER:     printf("%0.10g\n", json_to_double(value)); break;
+    default:              printf("%s\n", json_const_str(type));
+  }
+  return JSON_OK;
+}
+
+int main() {
+  char json[] = "{\"user\":{\"id\":42,\"timestamp\":1000},\"items\":[{\"price\":1.5,\"name\":\"a\"},{\"price\":2.25,\"timestamp\":1001}],\"timestamp\":1002}";
+  json_path_ctx path;
+  uint8_t result;
+
+  result = json_path_compile(&path, queries, sizeof(queries) / sizeof(queries[0]), print_match, NULL);
+  if(result) {
+    printf("Compile status: %s\n", result_to_string(result));
+    return 1;
+  }
+
+  printf("Output:\n");
+
+  // Decode JSON in-place, delivering only matching values
+  result = json_parse(json, strlen(json), json_path_callback, &path);
+
+  printf("\nCompletion status: %s\n\n", result_to_string(result));
+
+  // Nesting beyond JSON_NESTING is reported, matches up to there are delivered
+  char deep[] = "{\"items\":[[[[[[[[1]]]]]]]]}";
+  json_path_compile(&path, queries, sizeof(queries) / sizeof(queries[0]), print_match, NULL);
+  printf("Output (too deep):\n");
+  result = json_parse(deep, strlen(deep), json_path_callback, &path);
+  printf("\nCompletion status: %s\n\n", result_to_string(result));
+}
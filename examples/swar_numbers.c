@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "json.h"
+#include "helpers.h"
+
+// Requires JSON_SWAR_NUMBERS (also try with JSON_RAW_NUMBERS, JSON_SIMPLE_NUMBERS, JSON_NO_OVERFLOW_CHECK)
+// Numbers parsed from memory take the multi-digit path, the same numbers fed
+// one character at a time through json_octet take the plain path, both must agree
+
+const char *numbers[] = {
+  "0", "7", "12345678", "123456789", "4294967295", "4294967296", "-98765432", "-0",
+  "3.14159265", "0.000000000123", "1234.56789012", "12345678.87654321", "0.10000000000000000001",
+  "1e10", "2.5E-8", "-0.00000001", "99999999.99999999", "4294967295.5", "1.0000000000",
+  "123456781234567812345678", "12345678901234567890.5", "00000001", "1.", "[12345678,87654321]"
+};
+
+// Callback keeping last number in value passed as user
+uint8_t keep_number(uint32_t depth, uint8_t type, void * value, void * user) {
+  if(type == JSON_NUMBER) *(double *)user = json_to_double(value);
+  return JSON_OK;
+}
+
+int main() {
+  char json[64], jsbuf[64];
+  uint8_t result_swar, result_plain, n, k, errors = 0;
+  double swar, plain;
+  json_parser_ctx ctx;
+
+  printf("Output:\n");
+
+  for(n = 0; n < sizeof(numbers) / sizeof(numbers[0]); n++) {
+    // In memory, up to 8 digits at a time
+    swar = plain = 0;
+    strcpy(json, numbers[n]);
+    result_swar = json_parse(json, strlen(json), keep_number, &swar);
+
+    // One character at a time
+    ctx = json_stream(jsbuf, sizeof(jsbuf), keep_number, &plain);
+    for(k = 0, result_plain = JSON_OK; numbers[n][k] && !result_plain; k++) result_plain = json_octet(&ctx, numbers[n][k]);
+    if(!result_plain) result_plain = json_octet(&ctx, ' ');
+    if(!result_plain && !json_eof(&ctx)) result_plain = JSON_UNEXPECTED_END;
+
+    printf("%-26s %-16s %0.17g", numbers[n], result_to_string(result_swar), swar);
+    if(result_swar != result_plain || swar != plain) {
+      printf(" MISMATCH (%s %0.17g)", result_to_string(result_plain), plain);
+      errors++;
+    }
+    printf("\n");
+  }
+
+  printf("\n%u mismatches\n\n", errors);
+  return errors != 0;
+}
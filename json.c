@@ -3,6 +3,9 @@
 #include <string.h>
 #include <math.h>
 #include "json.h"
+#ifdef JSON_BASE64
+#include "latin1_utf8_b64.h"
+#endif
 
 // JSON parser states
 #define PSTATE_ENTITY        0
@@ -23,6 +26,12 @@
 #define GSTATE_ARRAY_POST    8
 #define GSTATE_EXIT          9
 
+// JSON Base64 value states
+#define BSTATE_OFF           0
+#define BSTATE_NEXT          1 // Requested for next value
+#define BSTATE_DATA          2
+#define BSTATE_PAD           3 // Padding seen, base64_count holds '=' still expected
+
 const char json_str_null[] = "null";
 const char json_str_true[] = "true";
 const char json_str_false[] = "false";
@@ -31,14 +40,96 @@ char *json_to_string(void * value) {
   return (char *)((json_string *)value)->string;
 }
 
+static const double json_pow10d[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Scale by power of ten, exact powers from table when possible
+// * Correctly rounded only while d is exact (integers up to 2^53) and the power is in the table
+static double json_scale(double d, int32_t e) {
+  if(e >= 0 && e <= 22) return d * json_pow10d[e];
+  if(e < 0 && e >= -22) return d / json_pow10d[-e];
+  return d * pow(10, e);
+}
+
+// Scale integer by power of ten into signed 64-bit integer
+static uint8_t json_int64(uint64_t m, int32_t e, bool negative, int64_t *result) {
+  while(m && e < 0 && m % 10 == 0) {
+    m /= 10;
+    e++;
+  }
+  if(m && e < 0) return JSON_NUMBER_OVERFLOW;
+  while(m && e-- > 0) {
+    if(m > UINT64_MAX / 10) return JSON_NUMBER_OVERFLOW;
+    m *= 10;
+  }
+  if(m > (uint64_t)INT64_MAX + (negative ? 1 : 0)) return JSON_NUMBER_OVERFLOW;
+  *result = negative && m ? -(int64_t)(m - 1) - 1 : (int64_t)m;
+  return JSON_OK;
+}
+
+#ifdef JSON_RAW_NUMBERS
+// Split number text into significant digits (as many as fit) and decimal exponent, returns false if digits were lost
+static bool json_number_split(json_number *ctx, uint64_t *mantissa, int32_t *exponent) {
+  const uint8_t *p = ctx->string;
+  uint64_t m = 0;
+  int32_t e = 0, x = 0;
+  bool fraction = false, exact = true;
+  if(*p == '-') p++;
+  for(; p < ctx->string_end && *p != 'e' && *p != 'E'; p++) {
+    if(*p == '.') {
+      fraction = true;
+    } else if(m <= (UINT64_MAX - 9) / 10) {
+      m = m * 10 + (*p - '0');
+      if(fraction) e--;
+    } else {
+      if(*p != '0') exact = false;
+      if(!fraction) e++;
+    }
+  }
+  if(p < ctx->string_end) {
+    p++;
+    if(*p == '+' || *p == '-') p++;
+    for(; p < ctx->string_end; p++) if(x < 100000) x = x * 10 + (*p - '0');
+    e += (ctx->flags & JSON_NFLAG_EXPNEG) ? -x : x;
+  }
+  *mantissa = m;
+  *exponent = e;
+  return exact;
+}
+
+double json_to_double(void * value) {
+  json_number *ctx = (json_number *)value;
+  uint64_t m;
+  int32_t e;
+  json_number_split(ctx, &m, &e);
+  return json_scale((double)m, e) * ((ctx->flags & JSON_NFLAG_NUMNEG) ? -1.0 : +1.0);
+}
+
+uint8_t json_to_int64(void * value, int64_t *result) {
+  json_number *ctx = (json_number *)value;
+  uint64_t m;
+  int32_t e;
+  if(!json_number_split(ctx, &m, &e)) return JSON_NUMBER_OVERFLOW;
+  return json_int64(m, e, ctx->flags & JSON_NFLAG_NUMNEG, result);
+}
+#else
 double json_to_double(void * value) {
   json_number *ctx = (json_number *)value;
   double d;
   d = (double)ctx->number * ((ctx->flags & JSON_NFLAG_NUMNEG) ? -1.0 : +1.0);
-  d *= pow(10, -(uint16_t)ctx->decimals + ((uint16_t)ctx->exponent * ((ctx->flags & JSON_NFLAG_EXPNEG) ? -1 : +1)));
-  return d;
+  return json_scale(d, -(int32_t)ctx->decimals + ((int32_t)ctx->exponent * ((ctx->flags & JSON_NFLAG_EXPNEG) ? -1 : +1)));
 }
 
+uint8_t json_to_int64(void * value, int64_t *result) {
+  json_number *ctx = (json_number *)value;
+  int32_t e;
+  if(!(ctx->flags & (JSON_NFLAG_FRACT | JSON_NFLAG_EXP))) return json_int64(ctx->number, 0, ctx->flags & JSON_NFLAG_NUMNEG, result);
+  // Fraction digits that did not fit the number are not covered by decimals, trailing zeros are
+  if(ctx->flags & JSON_NFLAG_DROPPED) return JSON_NUMBER_OVERFLOW;
+  e = -(int32_t)ctx->decimals + (int32_t)ctx->exponent * ((ctx->flags & JSON_NFLAG_EXPNEG) ? -1 : +1);
+  return json_int64(ctx->number, e, ctx->flags & JSON_NFLAG_NUMNEG, result);
+}
+#endif
+
 const char * json_const_str(uint8_t type) {
   switch(type) {
     case JSON_NULL: return json_str_null;
@@ -48,6 +139,184 @@ const char * json_const_str(uint8_t type) {
   return NULL;
 }
 
+#ifdef JSON_BATCH
+// Start string or constant after those still referenced by batched events, flushing when short of room
+static uint8_t json_batch_start(json_parser_ctx *ctx) {
+  uint8_t error = JSON_OK;
+  if(ctx->buffer_size && ctx->buffer_used + 6 > ctx->buffer_size) error = json_batch_flush(ctx);
+  ctx->u.s.string_end = ctx->u.s.string = ctx->buffer + ctx->buffer_used;
+  return error;
+}
+
+// Make room for string being decoded by flushing batch and moving string to start of buffer
+static uint8_t json_batch_reclaim(json_parser_ctx *ctx) {
+  uint8_t error;
+  uint16_t length = ctx->u.s.string_end - ctx->u.s.string;
+  if(ctx->u.s.string == ctx->buffer) return JSON_STRING_OVERFLOW;
+  error = json_batch_flush(ctx);
+  memmove(ctx->buffer, ctx->u.s.string, length);
+  ctx->u.s.string = ctx->buffer;
+  ctx->u.s.string_end = ctx->buffer + length;
+  return error;
+}
+#endif
+
+#ifdef JSON_INTERN
+// Look up string in interning table, adding it if new, and point it to the interned copy
+static void json_intern_value(json_intern_table *table, json_string *s) {
+  uint32_t length = s->string_end - s->string, hash = 2166136261u, n, id;
+  json_intern_entry *entry;
+  s->id = JSON_INTERN_NONE;
+  if(!table || !table->max_count || length > table->max_length) return;
+  for(n = 0; n < length; n++) hash = (hash ^ s->string[n]) * 16777619u; // FNV-1a
+  for(n = hash & table->slot_mask; (id = table->slots[n]); n = (n + 1) & table->slot_mask) {
+    entry = &table->entries[id - 1];
+    if(entry->hash == hash && entry->length == length && !memcmp(&table->text[entry->offset], s->string, length)) break;
+  }
+  if(!id) {
+    // New string, delivered as is if table is full
+    if(table->count == table->max_count || table->text_size - table->text_used < length + 1) return;
+    id = table->slots[n] = ++table->count;
+    entry = &table->entries[id - 1];
+    entry->hash = hash;
+    entry->offset = table->text_used;
+    entry->length = length;
+    memcpy(&table->text[entry->offset], s->string, length);
+    table->text[entry->offset + length] = 0;
+    table->text_used += length + 1;
+  }
+  s->string = &table->text[entry->offset];
+  s->string_end = s->string + length;
+  s->id = id;
+}
+#endif
+
+// Deliver event to callback, or collect it for batch
+static uint8_t json_emit(json_parser_ctx *ctx, uint32_t depth, uint8_t type, void *value) {
+#ifdef JSON_INTERN
+  if(type == JSON_KEY || type == JSON_STRING) json_intern_value(ctx->intern, &ctx->u.s);
+#endif
+#ifdef JSON_BATCH
+  if(ctx->batch) {
+    json_event *event = &ctx->batch[ctx->batch_count++];
+    event->depth = depth;
+    event->type = type;
+    if(value) event->u = ctx->u;
+    if(ctx->batch_count == ctx->batch_size) return json_batch_flush(ctx);
+    return JSON_OK;
+  }
+#endif
+  if(ctx->callback) {
+#ifdef JSON_ARRAY_CLAIM
+    if(type == JSON_ARRAY) {
+      ctx->claim.data = NULL;
+      value = &ctx->claim;
+    } else if(type == JSON_ARRAY_END && ctx->claim_depth == depth + 1) {
+      value = &ctx->claim;
+    }
+#endif
+#ifdef JSON_BASE64
+    if(type == JSON_KEY) {
+      uint8_t error = ctx->callback(depth, type, value, ctx->user);
+      if(error != JSON_DECODE_BASE64) return error;
+      if(ctx->base64_sink) ctx->base64_state = BSTATE_NEXT; // Without sink value is delivered as usual
+      return JSON_OK;
+    }
+#endif
+    return ctx->callback(depth, type, value, ctx->user);
+  }
+  return JSON_OK;
+}
+
+#ifdef JSON_ARRAY_CLAIM
+// Store number in claimed array
+static uint8_t json_claim_store(json_array *claim, json_number *number) {
+  int64_t i;
+  if(claim->count >= claim->size) return JSON_ARRAY_OVERFLOW;
+  switch(claim->type) {
+    case JSON_INT32:
+      if(json_to_int64(number, &i) || i < INT32_MIN || i > INT32_MAX) return JSON_ARRAY_MISMATCH;
+      ((int32_t *)claim->data)[claim->count] = (int32_t)i;
+      break;
+    case JSON_INT64:
+      if(json_to_int64(number, &i)) return JSON_ARRAY_MISMATCH;
+      ((int64_t *)claim->data)[claim->count] = i;
+      break;
+    case JSON_FLOAT:
+      ((float *)claim->data)[claim->count] = (float)json_to_double(number);
+      break;
+    case JSON_DOUBLE:
+      ((double *)claim->data)[claim->count] = json_to_double(number);
+      break;
+    default:
+      return JSON_ARRAY_MISMATCH;
+  }
+  claim->count++;
+  return JSON_OK;
+}
+
+// Decode run of plain elements of claimed array straight from memory, returns number of octets consumed
+// * Each element is taken with its separator: optional white-space, number without exponent, white-space and ','
+// * Anything else (last element, exponents, digits beyond 2^53 or JSON_NUM_MAX, errors) is left to json_octet
+static size_t json_claim_run(json_parser_ctx *ctx, const uint8_t *p, const uint8_t *end) {
+  json_array *claim = &ctx->claim;
+  const uint8_t *start = p, *q;
+#ifdef JSON_RAW_NUMBERS
+  const uint64_t max = 0x1FFFFFFFFFFFFFULL;
+#else
+  const uint64_t max = (uint64_t)JSON_NUM_MAX < 0x1FFFFFFFFFFFFFULL ? (uint64_t)JSON_NUM_MAX : 0x1FFFFFFFFFFFFFULL;
+#endif
+  uint64_t m;
+  uint8_t decimals;
+  bool negative;
+  double d;
+  if(ctx->claim.type < JSON_INT32 || ctx->claim.type > JSON_DOUBLE) return 0;
+  if(ctx->claim_depth != ctx->grammar_ctx.stack_depth) return 0;
+  if(ctx->grammar_ctx.state != GSTATE_ARRAY_IN && ctx->grammar_ctx.state != GSTATE_ARRAY_PRE) return 0;
+  while(claim->count < claim->size) {
+    q = p;
+    while(q < end && (*q == ' ' || *q == '\t' || *q == '\n' || *q == '\r')) q++;
+    negative = q < end && *q == '-';
+    if(negative) q++;
+    if(q >= end || *q < '0' || *q > '9') break;
+    if(*q == '0' && q + 1 < end && q[1] >= '0' && q[1] <= '9') break;
+    for(m = 0; q < end && *q >= '0' && *q <= '9' && m <= (max - (*q - '0')) / 10; q++) m = m * 10 + (*q - '0');
+    decimals = 0;
+#ifndef JSON_SIMPLE_NUMBERS
+    if(q < end && *q == '.' && (claim->type == JSON_FLOAT || claim->type == JSON_DOUBLE)) {
+      q++;
+      if(q >= end || *q < '0' || *q > '9') break;
+      for(; q < end && *q >= '0' && *q <= '9' && decimals < 22 && m <= (max - (*q - '0')) / 10; q++, decimals++) m = m * 10 + (*q - '0');
+    }
+#endif
+    while(q < end && (*q == ' ' || *q == '\t' || *q == '\n' || *q == '\r')) q++;
+    if(q >= end || *q != ',') break;
+    if(claim->type == JSON_INT32 && m > (negative ? 0x80000000ULL : 0x7FFFFFFFULL)) break;
+    switch(claim->type) {
+      case JSON_INT32:
+        ((int32_t *)claim->data)[claim->count] = (int32_t)(negative ? -(int64_t)m : (int64_t)m);
+        break;
+      case JSON_INT64:
+        ((int64_t *)claim->data)[claim->count] = negative ? -(int64_t)m : (int64_t)m;
+        break;
+      case JSON_FLOAT:
+      case JSON_DOUBLE:
+        d = json_scale((double)m, -(int32_t)decimals) * (negative ? -1.0 : +1.0);
+        if(claim->type == JSON_FLOAT) ((float *)claim->data)[claim->count] = (float)d;
+        else ((double *)claim->data)[claim->count] = d;
+        break;
+    }
+    claim->count++;
+    p = q + 1;
+    ctx->grammar_ctx.state = GSTATE_ARRAY_PRE;
+  }
+#ifdef JSON_CHECKPOINTS
+  ctx->offset += p - start;
+#endif
+  return p - start;
+}
+#endif
+
 static uint8_t json_parse_grammar(char type, json_parser_ctx *parser_ctx) {
   json_grammar_ctx * ctx = &parser_ctx->grammar_ctx;
 
@@ -56,18 +325,28 @@ static uint8_t json_parse_grammar(char type, json_parser_ctx *parser_ctx) {
 
   if(state == GSTATE_EXIT) return JSON_TRAILING_DATA;
 
+#ifdef JSON_BASE64
+  // Base64 request applies to the value following its key only
+  if(type != ':') parser_ctx->base64_state = BSTATE_OFF;
+#endif
+
+#ifdef JSON_ARRAY_CLAIM
+  // Claimed arrays hold numbers only
+  if(parser_ctx->claim_depth && parser_ctx->claim_depth == ctx->stack_depth && type != 'N' && type != ',' && type != ']') return JSON_ARRAY_MISMATCH;
+#endif
+
   if(type == '{') {
 
     // OBJECT BEGINS
     if(state == GSTATE_ENTER) {
       state = GSTATE_OBJECT_IN;
-      if(parser_ctx->callback) error = parser_ctx->callback(0, JSON_OBJECT, NULL, parser_ctx->user);
+      error = json_emit(parser_ctx, 0, JSON_OBJECT, NULL);
     } else if (state == GSTATE_ARRAY_IN || state == GSTATE_ARRAY_PRE) {
       state = GSTATE_OBJECT_IN;
-      if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, JSON_OBJECT, NULL, parser_ctx->user);
+      error = json_emit(parser_ctx, ctx->stack_depth, JSON_OBJECT, NULL);
     } else if(state == GSTATE_OBJECT_PRE) {
       state = GSTATE_OBJECT_IN;
-      if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, JSON_OBJECT, NULL, parser_ctx->user);
+      error = json_emit(parser_ctx, ctx->stack_depth, JSON_OBJECT, NULL);
     } else return JSON_BAD_GRAMMAR;
     
     if(ctx->stack_depth >= JSON_NESTING) return JSON_TOO_DEEP;
@@ -79,7 +358,7 @@ static uint8_t json_parse_grammar(char type, json_parser_ctx *parser_ctx) {
     // OBJECT ENDS
     if(state != GSTATE_OBJECT_IN && state != GSTATE_OBJECT_POST) return JSON_BAD_GRAMMAR;
     ctx->stack_depth--;
-    if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, JSON_OBJECT_END, NULL, parser_ctx->user);
+    error = json_emit(parser_ctx, ctx->stack_depth, JSON_OBJECT_END, NULL);
     if(ctx->stack_depth == 0) {
       state = GSTATE_EXIT;
     } else if((ctx->stack[(ctx->stack_depth - 1) >> 3] & (1 << ((ctx->stack_depth - 1) & 0x07))) == 0) {
@@ -93,24 +372,36 @@ static uint8_t json_parse_grammar(char type, json_parser_ctx *parser_ctx) {
     // ARRAY BEGINS
     if(state == GSTATE_ENTER) {
       state = GSTATE_ARRAY_IN;
-      if(parser_ctx->callback) error = parser_ctx->callback(0, JSON_ARRAY, NULL, parser_ctx->user);
+      error = json_emit(parser_ctx, 0, JSON_ARRAY, NULL);
     } else if (state == GSTATE_ARRAY_IN || state == GSTATE_ARRAY_PRE) {
       state = GSTATE_ARRAY_IN;
-      if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, JSON_ARRAY, NULL, parser_ctx->user);
+      error = json_emit(parser_ctx, ctx->stack_depth, JSON_ARRAY, NULL);
     } else if(state == GSTATE_OBJECT_PRE) {
       state = GSTATE_ARRAY_IN;
-      if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, JSON_ARRAY, NULL, parser_ctx->user);
+      error = json_emit(parser_ctx, ctx->stack_depth, JSON_ARRAY, NULL);
     } else return JSON_BAD_GRAMMAR;
     if(ctx->stack_depth >= JSON_NESTING) return JSON_TOO_DEEP;
     ctx->stack[(ctx->stack_depth >> 3)] &= ~(1 << (ctx->stack_depth & 0x07));
     ctx->stack_depth++;
+#ifdef JSON_ARRAY_CLAIM
+    if(parser_ctx->claim.data) {
+      parser_ctx->claim.count = 0;
+      parser_ctx->claim_depth = ctx->stack_depth;
+    }
+#endif
   
   } else if(type == ']') {
     
     // ARRAY ENDS
     if(state != GSTATE_ARRAY_IN && state != GSTATE_ARRAY_POST) return JSON_BAD_GRAMMAR;
     ctx->stack_depth--;
-    if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, JSON_ARRAY_END, NULL, parser_ctx->user);
+    error = json_emit(parser_ctx, ctx->stack_depth, JSON_ARRAY_END, NULL);
+#ifdef JSON_ARRAY_CLAIM
+    if(parser_ctx->claim_depth == ctx->stack_depth + 1) {
+      parser_ctx->claim_depth = 0;
+      parser_ctx->claim.data = NULL;
+    }
+#endif
     if(ctx->stack_depth == 0) {
       state = GSTATE_EXIT;
     } else if((ctx->stack[(ctx->stack_depth - 1) >> 3] & (1 << ((ctx->stack_depth - 1) & 0x07))) == 0) {
@@ -134,21 +425,28 @@ static uint8_t json_parse_grammar(char type, json_parser_ctx *parser_ctx) {
     } else if(state == GSTATE_OBJECT_POST) {
       state = GSTATE_OBJECT_KEY;
     } else return JSON_BAD_GRAMMAR;
+#ifdef JSON_CHECKPOINTS
+    // Top-level element done, checkpoint due at next token boundary after every N of them
+    if(ctx->stack_depth == 1 && parser_ctx->checkpoint_elements && ++parser_ctx->checkpoint_count == parser_ctx->checkpoint_elements) {
+      parser_ctx->checkpoint_count = 0;
+      parser_ctx->checkpoint_next = parser_ctx->offset;
+    }
+#endif
     
   } else if(type == 'S') {
     
     // STRING
     if(state == GSTATE_ENTER) {
       state = GSTATE_EXIT;
-      if(parser_ctx->callback) error = parser_ctx->callback(0, JSON_STRING, &parser_ctx->u.s, parser_ctx->user);
+      error = json_emit(parser_ctx, 0, JSON_STRING, &parser_ctx->u.s);
     } else if(state == GSTATE_ARRAY_IN || state == GSTATE_ARRAY_PRE) {
       state = GSTATE_ARRAY_POST;
-      if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, JSON_STRING, &parser_ctx->u.s, parser_ctx->user);
+      error = json_emit(parser_ctx, ctx->stack_depth, JSON_STRING, &parser_ctx->u.s);
     } else if(state == GSTATE_OBJECT_PRE) {
       state = GSTATE_OBJECT_POST;
-      if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, JSON_STRING, &parser_ctx->u.s, parser_ctx->user);
+      error = json_emit(parser_ctx, ctx->stack_depth, JSON_STRING, &parser_ctx->u.s);
     } else if(state == GSTATE_OBJECT_IN || state == GSTATE_OBJECT_KEY) {
-      if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, JSON_KEY, &parser_ctx->u.s, parser_ctx->user);
+      error = json_emit(parser_ctx, ctx->stack_depth, JSON_KEY, &parser_ctx->u.s);
       state = GSTATE_OBJECT_ASSIGN;
     } else return JSON_BAD_GRAMMAR;
     
@@ -157,13 +455,17 @@ static uint8_t json_parse_grammar(char type, json_parser_ctx *parser_ctx) {
     // NUMBER
     if(state == GSTATE_ENTER) {
       state = GSTATE_EXIT;
-      if(parser_ctx->callback) error = parser_ctx->callback(0, JSON_NUMBER, &parser_ctx->u.n, parser_ctx->user);
+      error = json_emit(parser_ctx, 0, JSON_NUMBER, &parser_ctx->u.n);
     } else if (state == GSTATE_ARRAY_IN || state == GSTATE_ARRAY_PRE) {
       state = GSTATE_ARRAY_POST;
-      if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, JSON_NUMBER, &parser_ctx->u.n, parser_ctx->user);
+#ifdef JSON_ARRAY_CLAIM
+      if(parser_ctx->claim_depth == ctx->stack_depth) error = json_claim_store(&parser_ctx->claim, &parser_ctx->u.n);
+      else
+#endif
+      error = json_emit(parser_ctx, ctx->stack_depth, JSON_NUMBER, &parser_ctx->u.n);
     } else if(state == GSTATE_OBJECT_PRE) {
       state = GSTATE_OBJECT_POST;
-      if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, JSON_NUMBER, &parser_ctx->u.n, parser_ctx->user);
+      error = json_emit(parser_ctx, ctx->stack_depth, JSON_NUMBER, &parser_ctx->u.n);
     } else return JSON_BAD_GRAMMAR;
     
   } else if(type == 'C') {
@@ -179,24 +481,204 @@ static uint8_t json_parse_grammar(char type, json_parser_ctx *parser_ctx) {
 
     if(state == GSTATE_ENTER) {
       state = GSTATE_EXIT;
-      if(parser_ctx->callback) error = parser_ctx->callback(0, type, NULL, parser_ctx->user);
+      error = json_emit(parser_ctx, 0, type, NULL);
     } else if(state == GSTATE_ARRAY_IN || state == GSTATE_ARRAY_PRE) {
       state = GSTATE_ARRAY_POST;
-      if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, type, NULL, parser_ctx->user);
+      error = json_emit(parser_ctx, ctx->stack_depth, type, NULL);
     } else if(state == GSTATE_OBJECT_PRE) {
       state = GSTATE_OBJECT_POST;
-      if(parser_ctx->callback) error = parser_ctx->callback(ctx->stack_depth, type, NULL, parser_ctx->user);
+      error = json_emit(parser_ctx, ctx->stack_depth, type, NULL);
     } else return JSON_BAD_GRAMMAR;
   }
 
   ctx->state = state;
 
+#ifdef JSON_BATCH
+  if(state == GSTATE_EXIT && !error) error = json_batch_flush(parser_ctx);
+#endif
+
+  return error;
+}
+
+#ifdef JSON_SWAR_NUMBERS
+#ifndef JSON_RAW_NUMBERS
+static const uint32_t json_pow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+#endif
+
+// Consume a run of up to 8 digits at once, returns number of characters consumed (0 = use json_octet)
+static uint8_t json_swar_digits(json_parser_ctx * ctx, const uint8_t *p) {
+  uint64_t x, t;
+#ifndef JSON_RAW_NUMBERS
+  uint32_t v;
+#endif
+  uint8_t k;
+  if(ctx->sub_state != 2 && ctx->sub_state != 4 && ctx->sub_state != 5) return 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  memcpy(&x, p, 8);
+#else
+  for(x = 0, k = 8; k--;) x = x << 8 | p[k]; // Portable little endian load
+#endif
+  // Non-zero bytes in t are non-digits, first digit is in lowest byte
+  t = ((x & 0xF0F0F0F0F0F0F0F0ULL) | (((x + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ^ 0x3333333333333333ULL;
+#if defined(__GNUC__)
+  k = t ? __builtin_ctzll(t) >> 3 : 8;
+#else
+  for(k = 0; k < 8 && !((t >> (k << 3)) & 0xFF); k++);
+#endif
+  if(k < 2) return 0;
+#ifdef JSON_RAW_NUMBERS
+  // Only keep the text
+  if(ctx->buffer_size && ctx->u.n.string_end + k - ctx->buffer >= ctx->buffer_size) return 0;
+  memmove(ctx->u.n.string_end, p, k);
+  ctx->u.n.string_end += k;
+  if(ctx->sub_state == 4) ctx->sub_state = 5;
+#else
+  // Left align digits (leading zeros) and combine pairs, quads and octets
+  x = (x - 0x3030303030303030ULL) << ((8 - k) << 3);
+  x = (x * 10 + (x >> 8)) & 0x00FF00FF00FF00FFULL;
+  x = (x * 100 + (x >> 16)) & 0x0000FFFF0000FFFFULL;
+  v = (uint32_t)((x * 10000 + (x >> 32)) & 0xFFFFFFFF);
+  if(ctx->sub_state == 2) {
+    // Integer part
+#ifndef JSON_NO_OVERFLOW_CHECK
+    if(v > JSON_NUM_MAX || ctx->u.n.number > (JSON_NUM_MAX - v) / json_pow10[k]) return 0;
+#endif
+    ctx->u.n.number = ctx->u.n.number * json_pow10[k] + v;
+  } else {
+    // Fraction, same bookkeeping as k rounds of sub_state 4/5
+#ifndef JSON_SIMPLE_NUMBERS
+#ifndef JSON_NO_OVERFLOW_CHECK
+    if(ctx->u.n.number > (JSON_NUM_MAX / 10) || v == 0) {
+      // Digits only count towards zero when they are all zeros or the number is full
+      if(ctx->u.n.zero > 0xFE - k) return 0;
+#else
+    if(v == 0) {
+#endif
+      if(v) ctx->u.n.flags |= JSON_NFLAG_DROPPED;
+      ctx->u.n.zero += k;
+    } else {
+      uint8_t trailing = 0;
+      uint16_t scale;
+      for(;;) {
+        while(v % 10 == 0) {
+          v /= 10;
+          trailing++;
+        }
+        scale = ctx->u.n.zero + k - trailing;
+#ifndef JSON_NO_OVERFLOW_CHECK
+        if(scale <= 9 && v <= JSON_NUM_MAX && ctx->u.n.number <= (JSON_NUM_MAX - v) / json_pow10[scale]) break;
+#else
+        if(scale <= 9) break;
+#endif
+        // Leave the last non-zero digit and what follows to json_octet
+        k -= trailing + 1;
+        v /= 10;
+        trailing = 0;
+        if(v == 0) return 0;
+      }
+      ctx->u.n.number = ctx->u.n.number * json_pow10[scale] + v;
+      ctx->u.n.decimals += scale;
+      ctx->u.n.zero = trailing;
+    }
+#endif
+    ctx->sub_state = 5;
+  }
+#endif
+#ifdef JSON_CHECKPOINTS
+  ctx->offset += k;
+#endif
+  return k;
+}
+#endif
+
+#ifdef JSON_BASE64
+// Deliver decoded octets to sink
+static uint8_t json_base64_flush(json_parser_ctx * ctx) {
+  uint8_t error = JSON_OK;
+  if(ctx->u.s.string_end != ctx->u.s.string) error = ctx->base64_sink(ctx->u.s.string, ctx->u.s.string_end - ctx->u.s.string, ctx->user);
+  ctx->u.s.string_end = ctx->u.s.string;
   return error;
 }
 
+// Decode octets of incomplete group (2 or 3 characters)
+static uint8_t json_base64_tail(json_parser_ctx * ctx) {
+  if(ctx->base64_count == 1) return JSON_MALFORMED_BASE64;
+  if(ctx->base64_count == 2) {
+    *ctx->u.s.string_end++ = ctx->base64_bits >> 4;
+  } else if(ctx->base64_count == 3) {
+    *ctx->u.s.string_end++ = ctx->base64_bits >> 10;
+    *ctx->u.s.string_end++ = ctx->base64_bits >> 2;
+  }
+  return JSON_OK;
+}
+
+// Decode character of Base64 string value, groups of 4 characters decode to 3 octets in buffer
+static uint8_t json_base64_octet(json_parser_ctx * ctx, uint8_t q) {
+  uint8_t error, v;
+  if(ctx->sub_state) {
+    // Escapes: only those that may occur in Base64 text
+    ctx->sub_state = 0;
+    if(q == 'r' || q == 'n') return JSON_OK;
+    if(q != '/') return JSON_MALFORMED_BASE64;
+  } else if(q == '\\') {
+    ctx->sub_state = 1;
+    return JSON_OK;
+  } else if(q == '"') {
+    if(ctx->base64_state == BSTATE_DATA) {
+      error = json_base64_tail(ctx);
+      if(error) return error;
+    } else if(ctx->base64_count) return JSON_MALFORMED_BASE64;
+    error = json_base64_flush(ctx);
+    if(error) return error;
+    *ctx->u.s.string_end = 0;
+    ctx->state = PSTATE_ENTITY;
+    return json_parse_grammar('S', ctx);
+  } else if(q == '=') {
+    if(ctx->base64_state == BSTATE_DATA) {
+      if(ctx->base64_count < 2) return JSON_MALFORMED_BASE64;
+      json_base64_tail(ctx);
+      ctx->base64_count = 3 - ctx->base64_count;
+      ctx->base64_state = BSTATE_PAD;
+    } else if(ctx->base64_count) {
+      ctx->base64_count--;
+    } else return JSON_MALFORMED_BASE64;
+    return JSON_OK;
+  }
+  v = base64_value(q);
+  if(v > 63 || ctx->base64_state == BSTATE_PAD) return JSON_MALFORMED_BASE64;
+  ctx->base64_bits = ctx->base64_bits << 6 | v;
+  if(++ctx->base64_count == 4) {
+    ctx->u.s.string_end[0] = ctx->base64_bits >> 16;
+    ctx->u.s.string_end[1] = ctx->base64_bits >> 8;
+    ctx->u.s.string_end[2] = ctx->base64_bits;
+    ctx->u.s.string_end += 3;
+    ctx->base64_count = 0;
+    // Keep room for next group (streaming buffer)
+    if(ctx->buffer_size && ctx->u.s.string_end + 3 > ctx->buffer + ctx->buffer_size) return json_base64_flush(ctx);
+  }
+  return JSON_OK;
+}
+#endif
+
 uint8_t json_octet(json_parser_ctx * ctx, uint8_t q) {
   uint8_t error = 0;
   bool repeat;
+#ifdef JSON_CHECKPOINTS
+  if(ctx->state == PSTATE_ENTITY && ctx->checkpoint_callback && ctx->offset >= ctx->checkpoint_next
+#ifdef JSON_ARRAY_CLAIM
+    && !ctx->claim_depth // Claim is not part of checkpoint, deferred to end of claimed array
+#endif
+#ifdef JSON_BASE64
+    && !ctx->base64_state // Neither is Base64 request, deferred to end of its value
+#endif
+    ) {
+    json_checkpoint checkpoint = {ctx->offset, ctx->grammar_ctx};
+    ctx->checkpoint_next = ctx->checkpoint_interval ? ctx->offset + ctx->checkpoint_interval : UINT64_MAX;
+    error = ctx->checkpoint_callback(&checkpoint, ctx->user);
+    if(error) return error;
+  }
+  ctx->offset++;
+#endif
   do {
     repeat = false;
     if(ctx->state == PSTATE_ENTITY) {
@@ -208,18 +690,38 @@ uint8_t json_octet(json_parser_ctx * ctx, uint8_t q) {
       } else if(q == '"') {
         // Start of string
         ctx->state = PSTATE_STRING;
+#ifdef JSON_BATCH
+        error = json_batch_start(ctx);
+#else
         ctx->u.s.string_end = ctx->u.s.string = ctx->buffer;
+#endif
         ctx->sub_state = 0;
+#ifdef JSON_BASE64
+        if(ctx->base64_state == BSTATE_NEXT) {
+          ctx->base64_state = ctx->grammar_ctx.state == GSTATE_OBJECT_PRE ? BSTATE_DATA : BSTATE_OFF;
+          ctx->base64_count = 0;
+        }
+#endif
       } else if(q == '-' || (q >= '0' && q <= '9')) {
         // Start of number
         ctx->state = PSTATE_NUMBER;
+#ifndef JSON_RAW_NUMBERS
         ctx->u.n.number = 0;
+#elif defined(JSON_BATCH)
+        error = json_batch_start(ctx);
+#else
+        ctx->u.n.string_end = ctx->u.n.string = ctx->buffer;
+#endif
         ctx->sub_state = 0;
         repeat = true;
       } else if(q >= 'a' && q <= 'z') {
         // Start of constant
         ctx->state = PSTATE_CONSTANT;
+#ifdef JSON_BATCH
+        error = json_batch_start(ctx);
+#else
         ctx->u.s.string_end = ctx->u.s.string = ctx->buffer;
+#endif
         repeat = true;
       } else return JSON_UNEXPECTED_CHARACTER;
     } else if(ctx->state == PSTATE_CONSTANT) {
@@ -232,16 +734,38 @@ uint8_t json_octet(json_parser_ctx * ctx, uint8_t q) {
         *ctx->u.s.string_end++ = q;
       }
     } else if(ctx->state == PSTATE_STRING) {
+#ifdef JSON_BASE64
+      if(ctx->base64_state) {
+        error = json_base64_octet(ctx, q);
+      } else
+#endif
       if(ctx->sub_state == 0) {
         if(q == '"') {
           *ctx->u.s.string_end = 0;
+#ifdef JSON_BATCH
+          if(ctx->batch && ctx->buffer_size) ctx->buffer_used = ctx->u.s.string_end + 1 - ctx->buffer;
+#endif
           error = json_parse_grammar('S', ctx);
           ctx->state = PSTATE_ENTITY;
         } else if(q == '\\') {
           ctx->sub_state = 1;
+#ifdef JSON_BATCH
+          if(ctx->buffer_size && ctx->u.s.string_end + 4 - ctx->buffer > ctx->buffer_size) {
+            error = json_batch_reclaim(ctx); // Escapes decode to at most 3 octets, plus terminating zero
+            if(error) return error;
+            if(ctx->u.s.string_end + 4 - ctx->buffer > ctx->buffer_size) return JSON_STRING_OVERFLOW;
+          }
+#endif
         } else if(q > 0x1F) {
           *ctx->u.s.string_end++ = q;
+#ifdef JSON_BATCH
+          if(ctx->buffer_size && ctx->u.s.string_end - ctx->buffer >= ctx->buffer_size) {
+            error = json_batch_reclaim(ctx);
+            if(error) return error;
+          }
+#else
           if(ctx->buffer_size && ctx->u.s.string_end - ctx->u.s.string >= ctx->buffer_size) return JSON_STRING_OVERFLOW;
+#endif
         } else {
           return JSON_MALFORMED_STRING;
         }
@@ -291,6 +815,49 @@ uint8_t json_octet(json_parser_ctx * ctx, uint8_t q) {
         }
       }
     } else if(ctx->state == PSTATE_NUMBER) {
+#ifdef JSON_RAW_NUMBERS
+      // Validate only, text is kept for conversion on demand
+      if(ctx->sub_state == 0) {
+        ctx->u.n.flags = q == '-' ? JSON_NFLAG_NUMNEG : 0;
+        ctx->sub_state = 1;
+        repeat = q != '-';
+      } else if(ctx->sub_state == 1 || ctx->sub_state == 4 || ctx->sub_state == 7) {
+        if(q < '0' || q > '9') return JSON_MALFORMED_NUMBER;
+        if(ctx->sub_state == 1) ctx->sub_state = q == '0' ? 3 : 2;
+        else ctx->sub_state++;
+      } else if(ctx->sub_state == 6) {
+        ctx->u.n.flags |= JSON_NFLAG_EXP;
+        if(q == '-') ctx->u.n.flags |= JSON_NFLAG_EXPNEG;
+        if(q == '+' || q == '-') ctx->sub_state = 7;
+        else if(q >= '0' && q <= '9') ctx->sub_state = 8;
+        else return JSON_MALFORMED_NUMBER;
+      } else if(q >= '0' && q <= '9' && ctx->sub_state != 3) {
+        // More digits
+      } else if(q == '.' && ctx->sub_state < 4) {
+        ctx->u.n.flags |= JSON_NFLAG_FRACT;
+        ctx->sub_state = 4;
+      } else if((q == 'e' || q == 'E') && ctx->sub_state < 6) {
+        ctx->sub_state = 6;
+      } else {
+#ifdef JSON_BATCH
+        if(ctx->batch && ctx->buffer_size) ctx->buffer_used = ctx->u.n.string_end - ctx->buffer;
+#endif
+        error = json_parse_grammar('N', ctx);
+        ctx->state = PSTATE_ENTITY;
+        repeat = true;
+      }
+      if(ctx->state == PSTATE_NUMBER && !repeat) {
+        *ctx->u.n.string_end++ = q;
+        if(ctx->buffer_size && ctx->u.n.string_end - ctx->buffer >= ctx->buffer_size) {
+#ifdef JSON_BATCH
+          if(ctx->u.n.string == ctx->buffer) return JSON_NUMBER_OVERFLOW;
+          error = json_batch_reclaim(ctx);
+#else
+          return JSON_NUMBER_OVERFLOW;
+#endif
+        }
+      }
+#else
       if(ctx->sub_state == 0) {
         if(q == '-') {
           ctx->u.n.flags = JSON_NFLAG_NUMNEG;
@@ -318,6 +885,7 @@ uint8_t json_octet(json_parser_ctx * ctx, uint8_t q) {
 #endif
           ctx->u.n.number += q - '0';
         } else if(q == '.') {
+          ctx->u.n.flags |= JSON_NFLAG_FRACT;
           ctx->sub_state = 4;
         } else if(q == 'e' || q == 'E') {
           ctx->sub_state = 6;
@@ -328,6 +896,7 @@ uint8_t json_octet(json_parser_ctx * ctx, uint8_t q) {
         }
       } else if(ctx->sub_state == 3) {
         if(q == '.') {
+          ctx->u.n.flags |= JSON_NFLAG_FRACT;
           ctx->sub_state = 4;
         } else if(q == 'e' || q == 'E') {
           ctx->sub_state = 6;
@@ -348,7 +917,7 @@ uint8_t json_octet(json_parser_ctx * ctx, uint8_t q) {
 #ifndef JSON_NO_OVERFLOW_CHECK
             ctx->u.n.zero++;
 #else
-            ctx->decimals += ++ctx->u.n.zero;
+            ctx->u.n.decimals += ++ctx->u.n.zero;
 #endif              
             while(ctx->u.n.zero) {
 #ifndef JSON_NO_OVERFLOW_CHECK
@@ -359,6 +928,7 @@ uint8_t json_octet(json_parser_ctx * ctx, uint8_t q) {
               ctx->u.n.zero--;
             }
             if(ctx->u.n.zero == 0 && ctx->u.n.number <= JSON_NUM_MAX - (q - '0')) ctx->u.n.number += q - '0';
+            else ctx->u.n.flags |= JSON_NFLAG_DROPPED;
           }
 #endif
           ctx->sub_state = 5;
@@ -375,7 +945,7 @@ uint8_t json_octet(json_parser_ctx * ctx, uint8_t q) {
 #ifndef JSON_NO_OVERFLOW_CHECK
             ctx->u.n.zero++;
 #else
-            ctx->decimals += ++ctx->u.n.zero;
+            ctx->u.n.decimals += ++ctx->u.n.zero;
 #endif              
             while(ctx->u.n.zero) {
 #ifndef JSON_NO_OVERFLOW_CHECK
@@ -386,6 +956,7 @@ uint8_t json_octet(json_parser_ctx * ctx, uint8_t q) {
               ctx->u.n.zero--;
             }
             if(ctx->u.n.zero == 0 && ctx->u.n.number <= JSON_NUM_MAX - (q - '0')) ctx->u.n.number += q - '0';
+            else ctx->u.n.flags |= JSON_NFLAG_DROPPED;
           }
 #endif
           } else if(q == 'e' || q == 'E') {
@@ -396,9 +967,10 @@ uint8_t json_octet(json_parser_ctx * ctx, uint8_t q) {
           repeat = true;
         }
       } else if(ctx->sub_state == 6) {
+        ctx->u.n.flags |= JSON_NFLAG_EXP;
         if(q >= '0' && q <= '9') {
 #ifndef JSON_SIMPLE_NUMBERS
-          ctx->u.n.exponent = 1;
+          ctx->u.n.exponent = (q - '0');
 #endif
           ctx->sub_state = 8;
         } else if(q == '+' || q == '-') {
@@ -428,6 +1000,7 @@ uint8_t json_octet(json_parser_ctx * ctx, uint8_t q) {
           repeat = true;
         }
       }
+#endif
     } else error = JSON_BAD_STATE;
   } while(repeat && !error);
   return error;
@@ -437,20 +1010,214 @@ bool json_eof(json_parser_ctx * ctx) {
   return ctx->state == 0 && ctx->grammar_ctx.state == GSTATE_EXIT;
 }
 
+uint8_t json_block(json_parser_ctx * ctx, const char *data, size_t length) {
+  const uint8_t *p = (const uint8_t *)data, *end = p + length;
+  uint8_t error;
+#ifdef JSON_SWAR_NUMBERS
+  uint8_t k;
+#endif
+#ifdef JSON_ARRAY_CLAIM
+  size_t c;
+#endif
+  while(p < end) {
+#ifdef JSON_ARRAY_CLAIM
+    if(ctx->claim_depth && ctx->state == PSTATE_ENTITY && (c = json_claim_run(ctx, p, end))) {
+      p += c;
+      continue;
+    }
+#endif
+#ifdef JSON_SWAR_NUMBERS
+    if(ctx->state == PSTATE_NUMBER && end - p >= 8 && (k = json_swar_digits(ctx, p))) {
+      p += k;
+      continue;
+    }
+#endif
+    error = json_octet(ctx, *p++);
+    if(error) return error;
+  }
+  return JSON_OK;
+}
+
 json_parser_ctx json_stream(char *buffer, uint16_t buffer_size, json_cb callback, void * user) {
   return (json_parser_ctx){callback, user, (uint8_t *)buffer, buffer_size, buffer_size >= 5 ? PSTATE_ENTITY : PSTATE_INVALID};
 }
 
-uint8_t json_parse(char *data, size_t length, json_cb callback, void * user) {
+#ifdef JSON_CHECKPOINTS
+void json_checkpoints(json_parser_ctx * ctx, uint32_t interval, json_checkpoint_cb callback) {
+  ctx->checkpoint_interval = interval;
+  ctx->checkpoint_elements = 0;
+  ctx->checkpoint_next = ctx->offset + interval;
+  ctx->checkpoint_callback = callback;
+}
+
+void json_checkpoints_elements(json_parser_ctx * ctx, uint32_t elements, json_checkpoint_cb callback) {
+  ctx->checkpoint_interval = 0;
+  ctx->checkpoint_elements = elements;
+  ctx->checkpoint_count = 0;
+  ctx->checkpoint_next = UINT64_MAX;
+  ctx->checkpoint_callback = callback;
+}
+
+json_parser_ctx json_resume(json_checkpoint * checkpoint, char *buffer, uint16_t buffer_size, json_cb callback, void * user) {
+  json_parser_ctx ctx = json_stream(buffer, buffer_size, callback, user);
+  ctx.grammar_ctx = checkpoint->grammar_ctx;
+  ctx.offset = checkpoint->offset;
+  return ctx;
+}
+#endif
+
+#ifdef JSON_BASE64
+void json_base64(json_parser_ctx * ctx, json_base64_cb sink) {
+  ctx->base64_sink = sink;
+}
+#endif
+
+#ifdef JSON_INTERN
+bool json_intern_init(json_intern_table * table, void * arena, size_t size, uint32_t max_count, uint16_t max_length) {
+  size_t slot_count = 1, align, index_size;
+  uint8_t *p = (uint8_t *)arena;
+  align = (4 - (uintptr_t)p % 4) % 4;
+  // Slot mask is 32-bit, limits checked in steps so sizes can not wrap
+  if(!max_count || max_count > 0x80000000u / 2 || align > size) {
+    memset(table, 0, sizeof(json_intern_table)); // Interns nothing
+    return false;
+  }
+  while(slot_count < (size_t)max_count * 2) slot_count <<= 1; // At most half full, keeps probing short
+  if(slot_count > (size - align) / sizeof(uint32_t) || max_count > (size - align - slot_count * sizeof(uint32_t)) / sizeof(json_intern_entry)) {
+    memset(table, 0, sizeof(json_intern_table));
+    return false;
+  }
+  p += align;
+  index_size = slot_count * sizeof(uint32_t) + (size_t)max_count * sizeof(json_intern_entry);
+  table->slots = (uint32_t *)p;
+  table->entries = (json_intern_entry *)(p + slot_count * sizeof(uint32_t));
+  table->text = p + index_size;
+  memset(table->slots, 0, slot_count * sizeof(uint32_t));
+  table->slot_mask = (uint32_t)(slot_count - 1);
+  table->count = 0;
+  table->max_count = max_count;
+  table->text_used = 0;
+  table->text_size = (uint8_t *)arena + size - table->text > 0xFFFFFFFF ? 0xFFFFFFFF : (uint8_t *)arena + size - table->text;
+  table->max_length = max_length;
+  return true;
+}
+
+void json_intern(json_parser_ctx * ctx, json_intern_table * table) {
+  ctx->intern = table;
+}
+
+json_string json_intern_string(json_intern_table * table, uint32_t id) {
+  json_string s = {NULL, NULL, JSON_INTERN_NONE};
+  if(id == JSON_INTERN_NONE || id > table->count) return s;
+  s.string = &table->text[table->entries[id - 1].offset];
+  s.string_end = s.string + table->entries[id - 1].length;
+  s.id = id;
+  return s;
+}
+#endif
+
+#ifdef JSON_BATCH
+void json_batch(json_parser_ctx * ctx, json_event * events, uint16_t size, json_batch_cb callback) {
+  ctx->batch = events;
+  ctx->batch_size = size;
+  ctx->batch_count = 0;
+  ctx->batch_callback = callback;
+}
+
+uint8_t json_batch_flush(json_parser_ctx * ctx) {
+  uint8_t error = JSON_OK;
+  if(ctx->batch && ctx->batch_count) error = ctx->batch_callback(ctx->batch, ctx->batch_count, ctx->user);
+  ctx->batch_count = 0;
+  ctx->buffer_used = 0;
+  return error;
+}
+#endif
+
+static uint8_t json_parse_ctx(json_parser_ctx * ctx, size_t length) {
   size_t n;
   uint8_t error = 0;
-  json_parser_ctx ctx = {callback, user, (uint8_t *)data};
-  for(n = 0; n < length; n++, ctx.buffer++) {
-    error = json_octet(&ctx, *ctx.buffer); // Process character
+#ifdef JSON_SWAR_NUMBERS
+  uint8_t k;
+#endif
+#ifdef JSON_ARRAY_CLAIM
+  size_t c;
+#endif
+  for(n = 0; n < length; n++, ctx->buffer++) {
+#ifdef JSON_ARRAY_CLAIM
+    if(ctx->claim_depth && ctx->state == PSTATE_ENTITY && (c = json_claim_run(ctx, ctx->buffer, ctx->buffer + (length - n)))) {
+      n += c - 1; // Loop steps over the last one
+      ctx->buffer += c - 1;
+      continue;
+    }
+#endif
+#ifdef JSON_SWAR_NUMBERS
+    if(ctx->state == PSTATE_NUMBER && length - n >= 8 && (k = json_swar_digits(ctx, ctx->buffer))) {
+      n += k - 1; // Loop steps over the last one
+      ctx->buffer += k - 1;
+      continue;
+    }
+#endif
+    error = json_octet(ctx, *ctx->buffer); // Process character
     if(error) return error;
   }
-  error = json_octet(&ctx, ' '); // Terminate "lonely" values
+  error = json_octet(ctx, ' '); // Terminate "lonely" values
   if(error) return error;
-  if(json_eof(&ctx)) return JSON_OK;
+  if(json_eof(ctx)) return JSON_OK;
   return JSON_UNEXPECTED_END;
 }
+
+uint8_t json_parse(char *data, size_t length, json_cb callback, void * user) {
+  json_parser_ctx ctx = {callback, user, (uint8_t *)data};
+  return json_parse_ctx(&ctx, length);
+}
+
+uint8_t json_replay(const json_event * events, size_t count, json_cb callback, void * user) {
+  size_t n;
+  uint8_t error;
+#ifdef JSON_ARRAY_CLAIM
+  json_array claim;
+  uint32_t claim_depth = 0; // Depth + 1 of claimed array
+#endif
+  for(n = 0; n < count; n++) {
+#ifdef JSON_ARRAY_CLAIM
+    // Arrays are offered for claiming and claimed ones filled from their numbers, as when parsing
+    if(claim_depth) {
+      if(events[n].type == JSON_ARRAY_END && events[n].depth + 1 == claim_depth) {
+        claim_depth = 0;
+        error = callback(events[n].depth, JSON_ARRAY_END, &claim, user);
+      } else if(events[n].type == JSON_NUMBER) {
+        error = json_claim_store(&claim, (json_number *)&events[n].u.n);
+      } else {
+        error = JSON_ARRAY_MISMATCH;
+      }
+      if(error) return error;
+      continue;
+    }
+    if(events[n].type == JSON_ARRAY) {
+      claim.data = NULL;
+      error = callback(events[n].depth, JSON_ARRAY, &claim, user);
+      if(error) return error;
+      if(claim.data) {
+        claim.count = 0;
+        claim_depth = events[n].depth + 1;
+      }
+      continue;
+    }
+#endif
+    if(events[n].type == JSON_KEY || events[n].type == JSON_STRING || events[n].type == JSON_NUMBER) {
+      error = callback(events[n].depth, events[n].type, (void *)&events[n].u, user);
+    } else {
+      error = callback(events[n].depth, events[n].type, NULL, user);
+    }
+    if(error) return error;
+  }
+  return JSON_OK;
+}
+
+#ifdef JSON_BATCH
+uint8_t json_parse_batch(char *data, size_t length, json_event * events, uint16_t size, json_batch_cb callback, void * user) {
+  json_parser_ctx ctx = {NULL, user, (uint8_t *)data};
+  json_batch(&ctx, events, size, callback);
+  return json_parse_ctx(&ctx, length);
+}
+#endif
\ No newline at end of file
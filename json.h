@@ -1,3 +1,6 @@
+#ifndef JSON_H
+#define JSON_H
+
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -5,6 +8,15 @@
 //#define JSON_NO_OVERFLOW_CHECK     // Disable number overflow checks 
 //#define JSON_SIMPLE_NUMBERS        // Disable fractions and exponents for numbers
 
+// JSON performance options
+//#define JSON_RAW_NUMBERS           // Deliver numbers as validated source text, converted only on demand (json_to_double, json_to_int64)
+//#define JSON_SWAR_NUMBERS          // Convert up to 8 digits at a time from in-memory data (needs fast 64-bit math)
+//#define JSON_CHECKPOINTS           // Track input offset and report resumable checkpoints while streaming
+//#define JSON_BATCH                 // Allow delivering events in batches instead of one callback each
+//#define JSON_ARRAY_CLAIM           // Allow JSON_ARRAY callback to claim numeric array for decoding into a buffer
+//#define JSON_BASE64                // Allow JSON_KEY callback to have Base64 string value decoded into a sink (needs latin1_utf8_b64.c)
+//#define JSON_INTERN                // Allow interning keys and strings into a table, giving stable pointers and ids
+
 // JSON nesting depth
 #define JSON_NESTING              8 // Max 64k
 
@@ -17,6 +29,9 @@
 // JSON number flags
 #define JSON_NFLAG_NUMNEG  (1 << 0)
 #define JSON_NFLAG_EXPNEG  (1 << 1)
+#define JSON_NFLAG_FRACT   (1 << 2) // Has fraction
+#define JSON_NFLAG_EXP     (1 << 3) // Has exponent
+#define JSON_NFLAG_DROPPED (1 << 4) // Non-zero fraction digits did not fit number (not JSON_RAW_NUMBERS)
 
 // JSON error codes
 #define JSON_OK                   0
@@ -32,8 +47,17 @@
 #define JSON_NUMBER_OVERFLOW     10 // One or more parts of a number exceeded set limits (JSON number configuration)
 #define JSON_STRING_OVERFLOW     11 // String length exceeded (JSON_MAX_STRING)
 #define JSON_BAD_STATE           12 // Programming error lead to bad state
+#define JSON_BAD_PATH            13 // Path query malformed or exceeds limits (json_path.h)
+#define JSON_ARRAY_MISMATCH      14 // Claimed array element does not fit its type
+#define JSON_ARRAY_OVERFLOW      15 // Claimed array has more elements than its buffer
+#define JSON_MALFORMED_BASE64    16 // Base64 string value contains characters outside alphabet or bad padding
+#define JSON_IMAGE_OVERFLOW      17 // Image buffer or scratch stack too small (json_image.h)
+#define JSON_BAD_IMAGE           18 // Image header or node invalid (json_image.h)
 #define JSON_CUSTOM_ERROR       128 // Custom errors from callback (128-255)
 
+// JSON callback requests (returned instead of JSON_OK)
+#define JSON_DECODE_BASE64      127 // From JSON_KEY: decode string value as Base64 into sink (JSON_BASE64)
+
 // JSON object types
 #define JSON_OBJECT               0
 #define JSON_OBJECT_END           1
@@ -47,6 +71,12 @@
 #define JSON_TRUE                 9
 #define JSON_FALSE               10
 
+// JSON claimed array element types
+#define JSON_INT32                1
+#define JSON_INT64                2
+#define JSON_FLOAT                3
+#define JSON_DOUBLE               4
+
 // Memory compare function (AVR f.ex. requires special procedure for comparing to below ROM strings)
 #define JSON_MEMCMP(RAM, ROM, LENGTH) memcmp(RAM, ROM, LENGTH)
 
@@ -58,6 +88,13 @@ extern const char json_str_false[];
 typedef uint8_t (*json_cb)(uint32_t depth, uint8_t type, void * value, void * user);
 
 // JSON number representation
+#ifdef JSON_RAW_NUMBERS
+typedef struct {
+  uint8_t * string;     // Number text as found in data (not terminated)
+  uint8_t * string_end;
+  uint8_t   flags;
+} json_number;
+#else
 typedef struct {
   JSON_NUM_TYPE number;
   JSON_EXP_TYPE exponent;
@@ -65,18 +102,88 @@ typedef struct {
   uint8_t      decimals;
   uint8_t      flags;
 } json_number;
+#endif
 
 typedef struct {
   uint8_t * string;
   uint8_t * string_end;
+#ifdef JSON_INTERN
+  uint32_t id;          // Interned string id (1 and up), JSON_INTERN_NONE if not interned
+#endif
 } json_string;
 
+typedef union {
+  json_string s;
+  json_number n;
+} json_value;
+
+// JSON claimed array (value of JSON_ARRAY, and of JSON_ARRAY_END of claimed arrays, with JSON_ARRAY_CLAIM)
+// * Set data, size and type on JSON_ARRAY to receive its numbers there instead of JSON_NUMBER events
+// * Count holds number of elements decoded on JSON_ARRAY_END, value is NULL there for arrays not claimed
+// * Plain numbers from memory (json_parse, json_block) are decoded by a dedicated loop, bypassing json_octet
+typedef struct {
+  void * data;
+  uint32_t size;
+  uint32_t count;
+  uint8_t type;
+} json_array;
+
+// JSON event record (batched delivery)
+typedef struct {
+  uint32_t depth;
+  uint8_t type;
+  json_value u;
+} json_event;
+
+// JSON batch callback
+typedef uint8_t (*json_batch_cb)(json_event * events, uint16_t count, void * user);
+
 typedef struct {
   uint8_t state;
   uint8_t stack[(JSON_NESTING + 7) / 8];
   uint16_t stack_depth;
 } json_grammar_ctx;
 
+#ifdef JSON_INTERN
+#define JSON_INTERN_NONE          0
+
+// JSON interned string
+typedef struct {
+  uint32_t hash;
+  uint32_t offset;      // In text
+  uint32_t length;
+} json_intern_entry;
+
+// JSON interning table (set up in caller's arena by json_intern_init)
+typedef struct {
+  json_intern_entry * entries; // By id - 1
+  uint32_t * slots;            // Open addressing hash table of ids, 0 = free
+  uint8_t * text;              // Zero terminated strings
+  uint32_t slot_mask;
+  uint32_t count;
+  uint32_t max_count;
+  uint32_t text_used;
+  uint32_t text_size;
+  uint16_t max_length;
+} json_intern_table;
+#endif
+
+#ifdef JSON_BASE64
+// JSON Base64 sink, receives decoded octets in chunks of up to buffer size
+typedef uint8_t (*json_base64_cb)(uint8_t * data, size_t length, void * user);
+#endif
+
+#ifdef JSON_CHECKPOINTS
+// JSON resumable parser state (plain data, can be stored as-is for use by identically configured builds)
+typedef struct {
+  uint64_t offset;
+  json_grammar_ctx grammar_ctx;
+} json_checkpoint;
+
+// JSON checkpoint callback
+typedef uint8_t (*json_checkpoint_cb)(json_checkpoint * checkpoint, void * user);
+#endif
+
 typedef struct {
   json_cb callback;
   void * user;
@@ -84,11 +191,36 @@ typedef struct {
   uint16_t buffer_size;
   uint8_t state;
   uint8_t sub_state;
-  union {
-    json_string s;
-    json_number n;
-  } u;
+  json_value u;
   json_grammar_ctx grammar_ctx;
+#ifdef JSON_CHECKPOINTS
+  uint64_t offset;
+  uint64_t checkpoint_next;
+  uint32_t checkpoint_interval;
+  uint32_t checkpoint_elements;
+  uint32_t checkpoint_count;
+  json_checkpoint_cb checkpoint_callback;
+#endif
+#ifdef JSON_ARRAY_CLAIM
+  json_array claim;
+  uint16_t claim_depth;
+#endif
+#ifdef JSON_BATCH
+  json_event * batch;
+  uint16_t batch_size;
+  uint16_t batch_count;
+  uint16_t buffer_used;
+  json_batch_cb batch_callback;
+#endif
+#ifdef JSON_BASE64
+  json_base64_cb base64_sink;
+  uint32_t base64_bits;
+  uint8_t base64_state;
+  uint8_t base64_count;
+#endif
+#ifdef JSON_INTERN
+  json_intern_table * intern;
+#endif
 } json_parser_ctx;
 
 // JSON type (constants only) to string
@@ -97,6 +229,10 @@ const char * json_const_str(uint8_t type);
 // JSON value to double
 double json_to_double(void *value);
 
+// JSON value to 64-bit integer
+// * Returns JSON_NUMBER_OVERFLOW if value is out of range or not a whole number
+uint8_t json_to_int64(void *value, int64_t *result);
+
 // JSON value to string
 char *json_to_string(void *value);
   
@@ -106,8 +242,71 @@ bool json_eof(json_parser_ctx * ctx);
 // JSON parse single character
 uint8_t json_octet(json_parser_ctx * ctx, uint8_t q);
 
+// JSON parse block of characters (streaming)
+uint8_t json_block(json_parser_ctx * ctx, const char *data, size_t length);
+
 // JSON return context for streaming
 json_parser_ctx json_stream(char *buffer, uint16_t buffer_size, json_cb callback, void * user);
 
+#ifdef JSON_CHECKPOINTS
+// JSON report checkpoint to callback at first token boundary after every interval octets
+// * Checkpoints hold no key path, keep your own alongside using the user pointer
+// * Checkpoints are deferred while inside a claimed array (JSON_ARRAY_CLAIM) or a value requested as Base64 (JSON_BASE64)
+void json_checkpoints(json_parser_ctx * ctx, uint32_t interval, json_checkpoint_cb callback);
+
+// JSON report checkpoint to callback after every N elements (or members) of the top-level container
+// * Checkpoint is at start of next element, replaces octet spacing set by json_checkpoints
+void json_checkpoints_elements(json_parser_ctx * ctx, uint32_t elements, json_checkpoint_cb callback);
+
+// JSON return context for streaming, resuming from checkpoint
+// * Input must continue from checkpoint->offset
+json_parser_ctx json_resume(json_checkpoint * checkpoint, char *buffer, uint16_t buffer_size, json_cb callback, void * user);
+#endif
+
+#ifdef JSON_BATCH
+// JSON collect events into array, calling callback with them when full or document ends
+// * Strings stay valid until callback returns (streaming buffer is shared by all strings in a batch)
+// * Arrays can not be claimed (JSON_ARRAY_CLAIM), their numbers are delivered as JSON_NUMBER events
+void json_batch(json_parser_ctx * ctx, json_event * events, uint16_t size, json_batch_cb callback);
+
+// JSON deliver collected events now
+uint8_t json_batch_flush(json_parser_ctx * ctx);
+#endif
+
+#ifdef JSON_BASE64
+// JSON set sink for string values requested as Base64 (JSON_DECODE_BASE64 from JSON_KEY callback)
+// * Value is delivered as an empty JSON_STRING after its last octets went to sink
+// * Padding is optional, escaped "\/" and line breaks ("\r", "\n") are accepted
+// * Not available with batched delivery (key events are not delivered one by one)
+// * Requests are ignored while no sink is set, value is then delivered as a JSON_STRING
+void json_base64(json_parser_ctx * ctx, json_base64_cb sink);
+#endif
+
+#ifdef JSON_INTERN
+// JSON set up interning table in arena for up to max_count strings of up to max_length octets
+// * Hash slots and entries are taken from the start of arena, the remainder holds string text
+// * Returns false if arena is too small (table then interns nothing)
+bool json_intern_init(json_intern_table * table, void * arena, size_t size, uint32_t max_count, uint16_t max_length);
+
+// JSON intern keys and strings while parsing
+// * Delivered strings then point into the table and stay valid as long as it does, ids are equal for equal strings
+// * Strings that are too long, or do not fit a full table, are delivered as usual with id JSON_INTERN_NONE
+void json_intern(json_parser_ctx * ctx, json_intern_table * table);
+
+// JSON interned string by id
+json_string json_intern_string(json_intern_table * table, uint32_t id);
+#endif
+
 // JSON in-place parser
-uint8_t json_parse(char *data, size_t length, json_cb callback, void * user);
\ No newline at end of file
+uint8_t json_parse(char *data, size_t length, json_cb callback, void * user);
+
+// JSON deliver recorded events to callback (f.ex. generated by tools/json_to_c.c)
+// * With JSON_ARRAY_CLAIM arrays can be claimed as when parsing, their recorded numbers then fill the buffer
+uint8_t json_replay(const json_event * events, size_t count, json_cb callback, void * user);
+
+#ifdef JSON_BATCH
+// JSON in-place parser, batched delivery
+uint8_t json_parse_batch(char *data, size_t length, json_event * events, uint16_t size, json_batch_cb callback, void * user);
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "json.h"
+#include "json_image.h"
+
+// Reserve aligned node with payload in image, returns offset (0 = no room)
+static uint32_t json_image_alloc(json_image_builder * b, uint8_t type, uint8_t flags, uint32_t count, uint32_t payload) {
+  uint32_t node = (b->used + 3) & ~3u;
+  json_image_node n = {type, flags, 0, count};
+  if(node < b->used || (uint64_t)node + sizeof(n) + payload > b->size) return 0;
+  memset(&b->image[b->used], 0, node - b->used); // Keeps images reproducible
+  memcpy(&b->image[node], &n, sizeof(n));
+  b->used = node + sizeof(n) + payload;
+  return node;
+}
+
+// Push offset to scratch stack
+static uint8_t json_image_push(json_image_builder * b, uint32_t offset) {
+  if(b->stack_used == b->stack_size) return JSON_IMAGE_OVERFLOW;
+  b->stack[b->stack_used++] = offset;
+  return JSON_OK;
+}
+
+// Compare keys of two object members
+static int json_image_compare(json_image_builder * b, uint32_t a, uint32_t c) {
+  json_image_node na, nc;
+  int r;
+  memcpy(&na, &b->image[a], sizeof(na));
+  memcpy(&nc, &b->image[c], sizeof(nc));
+  r = memcmp(&b->image[a + sizeof(na)], &b->image[c + sizeof(nc)], na.count < nc.count ? na.count : nc.count);
+  if(r) return r;
+  return na.count < nc.count ? -1 : na.count > nc.count;
+}
+
+// Sort member pairs (key, value) by key, shellsort keeps it in place without recursion
+static void json_image_sort(json_image_builder * b, uint32_t * pairs, uint32_t count) {
+  uint32_t gap, i, j, key, value;
+  for(gap = 1; gap < count / 3; gap = gap * 3 + 1);
+  for(; gap; gap /= 3) {
+    for(i = gap; i < count; i++) {
+      key = pairs[i * 2];
+      value = pairs[i * 2 + 1];
+      for(j = i; j >= gap && json_image_compare(b, pairs[(j - gap) * 2], key) > 0; j -= gap) {
+        pairs[j * 2] = pairs[(j - gap) * 2];
+        pairs[j * 2 + 1] = pairs[(j - gap) * 2 + 1];
+      }
+      pairs[j * 2] = key;
+      pairs[j * 2 + 1] = value;
+    }
+  }
+}
+
+void json_image_begin(json_image_builder * builder, void * image, uint32_t size, uint32_t * stack, uint32_t stack_size) {
+  builder->image = (uint8_t *)image;
+  builder->size = size;
+  builder->used = sizeof(json_image_header);
+  builder->stack = stack;
+  builder->stack_size = stack_size;
+  builder->stack_used = 0;
+  builder->frame = 0;
+  builder->open = 0;
+  builder->root = 0;
+}
+
+uint8_t json_image_callback(uint32_t depth, uint8_t type, void * value, void * user) {
+  json_image_builder * b = (json_image_builder *)user;
+  uint32_t node, count;
+  uint8_t error;
+  (void)depth;
+  if(type == JSON_OBJECT || type == JSON_ARRAY) {
+    // Open container, children are collected above its frame
+    error = json_image_push(b, b->frame);
+    if(error) return error;
+    b->frame = b->stack_used;
+    b->open++;
+    return JSON_OK;
+  } else if(type == JSON_OBJECT_END || type == JSON_ARRAY_END) {
+    // Close container, writing it after its children
+    count = b->stack_used - b->frame;
+    if(type == JSON_OBJECT_END) {
+      count /= 2;
+      json_image_sort(b, &b->stack[b->frame], count);
+    }
+    node = json_image_alloc(b, type == JSON_OBJECT_END ? JSON_OBJECT : JSON_ARRAY, 0, count, (b->stack_used - b->frame) * sizeof(uint32_t));
+    if(!node) return JSON_IMAGE_OVERFLOW;
+    memcpy(&b->image[node + sizeof(json_image_node)], &b->stack[b->frame], (b->stack_used - b->frame) * sizeof(uint32_t));
+    b->stack_used = b->frame - 1;
+    b->frame = b->stack[b->frame - 1];
+    b->open--;
+  } else if(type == JSON_KEY || type == JSON_STRING) {
+    json_string * s = (json_string *)value;
+    count = s->string_end - s->string;
+    node = json_image_alloc(b, JSON_STRING, 0, count, count + 1);
+    if(!node) return JSON_IMAGE_OVERFLOW;
+    memcpy(&b->image[node + sizeof(json_image_node)], s->string, count);
+    b->image[node + sizeof(json_image_node) + count] = 0;
+  } else if(type == JSON_NUMBER) {
+    int64_t i;
+    double d;
+    if(json_to_int64(value, &i) == JSON_OK) {
+      node = json_image_alloc(b, JSON_NUMBER, JSON_IMAGE_INTEGER, 0, sizeof(i));
+      if(!node) return JSON_IMAGE_OVERFLOW;
+      memcpy(&b->image[node + sizeof(json_image_node)], &i, sizeof(i));
+    } else {
+      d = json_to_double(value);
+      node = json_image_alloc(b, JSON_NUMBER, 0, 0, sizeof(d));
+      if(!node) return JSON_IMAGE_OVERFLOW;
+      memcpy(&b->image[node + sizeof(json_image_node)], &d, sizeof(d));
+    }
+  } else {
+    node = json_image_alloc(b, type, 0, 0, 0);
+    if(!node) return JSON_IMAGE_OVERFLOW;
+  }
+  // Completed node belongs to open container, or is the document
+  if(b->open) return json_image_push(b, node);
+  b->root = node;
+  return JSON_OK;
+}
+
+uint8_t json_image_end(json_image_builder * builder) {
+  json_image_header header = {JSON_IMAGE_MAGIC, JSON_IMAGE_VERSION, JSON_IMAGE_BYTE_ORDER, 0, 0};
+  if(!builder->root || builder->open) return JSON_UNEXPECTED_END;
+  while(builder->used % 4) {
+    if(builder->used == builder->size) return JSON_IMAGE_OVERFLOW;
+    builder->image[builder->used++] = 0;
+  }
+  header.size = builder->used;
+  header.root = builder->root;
+  memcpy(builder->image, &header, sizeof(header));
+  return JSON_OK;
+}
+
+uint8_t json_image_load(json_image * image, const void * data, size_t size) {
+  json_image_header header;
+  if(size < sizeof(header)) return JSON_BAD_IMAGE;
+  memcpy(&header, data, sizeof(header));
+  if(header.magic != JSON_IMAGE_MAGIC || header.version != JSON_IMAGE_VERSION || header.byte_order != JSON_IMAGE_BYTE_ORDER) return JSON_BAD_IMAGE;
+  if(header.size > size || header.root < sizeof(header) || header.root % 4 || header.root >= header.size) return JSON_BAD_IMAGE;
+  image->data = (const uint8_t *)data;
+  image->size = header.size;
+  image->root = header.root;
+  return JSON_OK;
+}
+
+// Read node, checking that it and its payload are inside image
+static bool json_image_node_at(const json_image * image, uint32_t node, json_image_node * n) {
+  uint64_t payload;
+  if(node < sizeof(json_image_header) || node % 4 || (uint64_t)node + sizeof(*n) > image->size) return false;
+  memcpy(n, &image->data[node], sizeof(*n));
+  switch(n->type) {
+    case JSON_OBJECT: payload = (uint64_t)n->count * 8; break;
+    case JSON_ARRAY:  payload = (uint64_t)n->count * 4; break;
+    case JSON_STRING: payload = (uint64_t)n->count + 1; break;
+    case JSON_NUMBER: payload = 8; break;
+    case JSON_NULL:
+    case JSON_TRUE:
+    case JSON_FALSE:  payload = 0; break;
+    default:          return false;
+  }
+  return node + sizeof(*n) + payload <= image->size;
+}
+
+// Read child offset of node, children must precede their parent
+static uint32_t json_image_child(const json_image * image, uint32_t node, uint32_t index) {
+  uint32_t child;
+  memcpy(&child, &image->data[node + sizeof(json_image_node) + index * 4], sizeof(child));
+  return child < node ? child : 0;
+}
+
+uint8_t json_image_type(const json_image * image, uint32_t node) {
+  json_image_node n;
+  if(!json_image_node_at(image, node, &n)) return JSON_IMAGE_INVALID;
+  return n.type;
+}
+
+uint32_t json_image_count(const json_image * image, uint32_t node) {
+  json_image_node n;
+  if(!json_image_node_at(image, node, &n)) return 0;
+  return n.type == JSON_OBJECT || n.type == JSON_ARRAY || n.type == JSON_STRING ? n.count : 0;
+}
+
+uint32_t json_image_get(const json_image * image, uint32_t node, const char * key, size_t length) {
+  json_image_node n, k;
+  uint32_t low = 0, high, mid, offset;
+  int r;
+  if(!json_image_node_at(image, node, &n) || n.type != JSON_OBJECT) return 0;
+  high = n.count;
+  while(low < high) {
+    mid = low + (high - low) / 2;
+    offset = json_image_child(image, node, mid * 2);
+    if(!json_image_node_at(image, offset, &k) || k.type != JSON_STRING) return 0;
+    r = memcmp(&image->data[offset + sizeof(k)], key, k.count < length ? k.count : length);
+    if(!r) r = k.count < length ? -1 : k.count > length;
+    if(!r) return json_image_child(image, node, mid * 2 + 1);
+    if(r < 0) low = mid + 1;
+    else high = mid;
+  }
+  return 0;
+}
+
+uint32_t json_image_index(const json_image * image, uint32_t node, uint32_t index) {
+  json_image_node n;
+  if(!json_image_node_at(image, node, &n) || index >= n.count) return 0;
+  if(n.type == JSON_ARRAY) return json_image_child(image, node, index);
+  if(n.type == JSON_OBJECT) return json_image_child(image, node, index * 2 + 1);
+  return 0;
+}
+
+uint32_t json_image_key(const json_image * image, uint32_t node, uint32_t index) {
+  json_image_node n;
+  if(!json_image_node_at(image, node, &n) || n.type != JSON_OBJECT || index >= n.count) return 0;
+  return json_image_child(image, node, index * 2);
+}
+
+const char * json_image_string(const json_image * image, uint32_t node) {
+  json_image_node n;
+  if(!json_image_node_at(image, node, &n) || n.type != JSON_STRING || image->data[node + sizeof(n) + n.count]) return NULL;
+  return (const char *)&image->data[node + sizeof(n)];
+}
+
+double json_image_double(const json_image * image, uint32_t node) {
+  json_image_node n;
+  int64_t i;
+  double d;
+  if(!json_image_node_at(image, node, &n) || n.type != JSON_NUMBER) return 0;
+  if(n.flags & JSON_IMAGE_INTEGER) {
+    memcpy(&i, &image->data[node + sizeof(n)], sizeof(i));
+    return (double)i;
+  }
+  memcpy(&d, &image->data[node + sizeof(n)], sizeof(d));
+  return d;
+}
+
+uint8_t json_image_int64(const json_image * image, uint32_t node, int64_t * result) {
+  json_image_node n;
+  double d;
+  if(!json_image_node_at(image, node, &n) || n.type != JSON_NUMBER) return JSON_BAD_IMAGE;
+  if(n.flags & JSON_IMAGE_INTEGER) {
+    memcpy(result, &image->data[node + sizeof(n)], sizeof(*result));
+    return JSON_OK;
+  }
+  memcpy(&d, &image->data[node + sizeof(n)], sizeof(d));
+  if(!(d >= -9223372036854775808.0 && d < 9223372036854775808.0) || d != (double)(int64_t)d) return JSON_NUMBER_OVERFLOW;
+  *result = (int64_t)d;
+  return JSON_OK;
+}
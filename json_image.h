@@ -0,0 +1,105 @@
+#ifndef JSON_IMAGE_H
+#define JSON_IMAGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "json.h"
+
+// JSON image format
+#define JSON_IMAGE_MAGIC 0x494A5953 // "SYJI"
+#define JSON_IMAGE_VERSION        1
+#define JSON_IMAGE_BYTE_ORDER 0x0102 // Stored in byte order of writer, images are only loaded by same byte order
+
+// JSON image node flags
+#define JSON_IMAGE_INTEGER        1 // Number holds int64_t (else double)
+
+// JSON image type of missing or invalid node
+#define JSON_IMAGE_INVALID     0xFF
+
+// JSON image header (at offset 0, all offsets are from start of image)
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t byte_order;
+  uint32_t size;        // Image size in octets
+  uint32_t root;        // Offset of root node
+} json_image_header;
+
+// JSON image node (4 octet aligned, children are always stored before their parent)
+// * JSON_OBJECT: count pairs of key (JSON_STRING) and value node offsets follow, sorted by key
+// * JSON_ARRAY: count element node offsets follow
+// * JSON_STRING: count octets and a terminating zero follow
+// * JSON_NUMBER: int64_t or double follows (JSON_IMAGE_INTEGER)
+// * JSON_NULL, JSON_TRUE, JSON_FALSE: nothing follows
+typedef struct {
+  uint8_t type;
+  uint8_t flags;
+  uint16_t reserved;
+  uint32_t count;
+} json_image_node;
+
+// JSON image builder
+typedef struct {
+  uint8_t * image;
+  uint32_t size;
+  uint32_t used;
+  uint32_t * stack;     // Scratch: frames of open containers and offsets of their children
+  uint32_t stack_size;
+  uint32_t stack_used;
+  uint32_t frame;       // Stack position of innermost open container
+  uint32_t open;        // Number of open containers
+  uint32_t root;
+} json_image_builder;
+
+// JSON image (loaded)
+typedef struct {
+  const uint8_t * data;
+  uint32_t size;
+  uint32_t root;
+} json_image;
+
+// JSON image prepare builder writing into image buffer of size octets
+// * Stack needs one entry per open container, plus one per element or two per member in them
+// * Offsets are 32-bit, so images are limited to 4 GiB
+// * Size needed is not known up front, on JSON_IMAGE_OVERFLOW parse again into larger buffers (from unmodified data)
+void json_image_begin(json_image_builder * builder, void * image, uint32_t size, uint32_t * stack, uint32_t stack_size);
+
+// JSON image parsing callback (pass json_image_builder as user)
+// * Returns JSON_IMAGE_OVERFLOW if image buffer or stack is too small
+uint8_t json_image_callback(uint32_t depth, uint8_t type, void * value, void * user);
+
+// JSON image write header once document is parsed, image size is then in builder->used
+uint8_t json_image_end(json_image_builder * builder);
+
+// JSON image load from memory (f.ex. mapped file), validating header
+// * Nodes are bounds checked when accessed, invalid ones appear as JSON_IMAGE_INVALID
+// * Returns JSON_BAD_IMAGE if header does not match this build or size
+uint8_t json_image_load(json_image * image, const void * data, size_t size);
+
+// JSON image type of node
+uint8_t json_image_type(const json_image * image, uint32_t node);
+
+// JSON image number of members, elements or string octets
+uint32_t json_image_count(const json_image * image, uint32_t node);
+
+// JSON image value of object member by key (binary search), 0 if not found
+uint32_t json_image_get(const json_image * image, uint32_t node, const char * key, size_t length);
+
+// JSON image element of array, or value of object member, by index (object members are in key order), 0 if not found
+uint32_t json_image_index(const json_image * image, uint32_t node, uint32_t index);
+
+// JSON image key of object member by index (JSON_STRING node), 0 if not found
+uint32_t json_image_key(const json_image * image, uint32_t node, uint32_t index);
+
+// JSON image string of node (zero terminated), NULL if not a string
+const char * json_image_string(const json_image * image, uint32_t node);
+
+// JSON image number of node as double
+double json_image_double(const json_image * image, uint32_t node);
+
+// JSON image number of node as 64-bit integer
+// * Returns JSON_NUMBER_OVERFLOW if number is not a whole number in range, JSON_BAD_IMAGE if node is not a number
+uint8_t json_image_int64(const json_image * image, uint32_t node, int64_t * result);
+
+#endif
@@ -0,0 +1,149 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "json.h"
+#include "json_path.h"
+
+static uint8_t json_path_compile_query(json_path_ctx * ctx, uint8_t query, const char * p) {
+  json_path_step *step;
+  uint8_t steps = 0;
+  uint8_t flags;
+  if(*p++ != '$') return JSON_BAD_PATH;
+  while(*p) {
+    if(steps >= JSON_PATH_STEPS) return JSON_BAD_PATH;
+    step = &ctx->step[query][steps++];
+    flags = 0;
+    if(p[0] == '.' && p[1] == '.') {
+      flags = JSON_PATH_DESCENDANT;
+      p += 1; // Leaves '.' in place unless followed by bracket
+      if(p[1] == '[') p++;
+    }
+    if(*p == '.') {
+      // Key or any key
+      p++;
+      if(*p == '*') {
+        step->type = JSON_PATH_ANY_KEY;
+        p++;
+      } else {
+        step->type = JSON_PATH_KEY;
+        step->key = p;
+        while(*p && *p != '.' && *p != '[') p++;
+        step->index = p - step->key;
+        if(step->index == 0) return JSON_BAD_PATH;
+      }
+    } else if(*p == '[') {
+      p++;
+      if(*p == '*') {
+        // Any index
+        step->type = JSON_PATH_ANY_INDEX;
+        p++;
+      } else if(*p == '\'') {
+        // Quoted key
+        step->type = JSON_PATH_KEY;
+        step->key = ++p;
+        while(*p && *p != '\'') p++;
+        if(*p++ != '\'') return JSON_BAD_PATH;
+        step->index = p - 1 - step->key;
+      } else {
+        // Index
+        step->type = JSON_PATH_INDEX;
+        step->index = 0;
+        if(*p < '0' || *p > '9') return JSON_BAD_PATH;
+        while(*p >= '0' && *p <= '9') {
+          if(step->index > (0xFFFFFFFF - (uint32_t)(*p - '0')) / 10) return JSON_BAD_PATH; // Index exceeds 32 bits
+          step->index = step->index * 10 + (*p++ - '0');
+        }
+      }
+      if(*p++ != ']') return JSON_BAD_PATH;
+    } else return JSON_BAD_PATH;
+    step->type |= flags;
+  }
+  ctx->steps[query] = steps;
+  return JSON_OK;
+}
+
+uint8_t json_path_compile(json_path_ctx * ctx, const char * const * queries, uint8_t count, json_path_cb callback, void * user) {
+  uint8_t n, error;
+  if(count > JSON_PATH_QUERIES) return JSON_BAD_PATH;
+  memset(ctx, 0, sizeof(json_path_ctx));
+  ctx->callback = callback;
+  ctx->user = user;
+  ctx->queries = count;
+  for(n = 0; n < count; n++) {
+    error = json_path_compile_query(ctx, n, queries[n]);
+    if(error) return error;
+    ctx->active[0][n] = 1; // Document root matches empty path
+  }
+  return JSON_OK;
+}
+
+// Advance query positions from parent container at depth - 1 to member at depth (key or index)
+static void json_path_advance(json_path_ctx * ctx, uint32_t depth, json_string * key, uint32_t index) {
+  uint8_t q, n;
+  uint32_t parent, child;
+  json_path_step *step;
+  bool match;
+  for(q = 0; q < ctx->queries; q++) {
+    parent = ctx->active[depth - 1][q];
+    child = 0;
+    for(n = 0; n < ctx->steps[q]; n++) {
+      if(!(parent & (1UL << n))) continue;
+      step = &ctx->step[q][n];
+      if(step->type & JSON_PATH_DESCENDANT) child |= 1UL << n;
+      switch(step->type & ~JSON_PATH_DESCENDANT) {
+        case JSON_PATH_KEY:       match = key && (uint32_t)(key->string_end - key->string) == step->index && !memcmp(key->string, step->key, step->index); break;
+        case JSON_PATH_ANY_KEY:   match = key; break;
+        case JSON_PATH_INDEX:     match = !key && index == step->index; break;
+        default:                  match = !key; break;
+      }
+      if(match) child |= 1UL << (n + 1);
+    }
+    ctx->active[depth][q] = child;
+  }
+}
+
+uint8_t json_path_callback(uint32_t depth, uint8_t type, void * value, void * user) {
+  json_path_ctx *ctx = (json_path_ctx *)user;
+  uint8_t q, error;
+
+  // Contents of a container no query can match within are skipped up to its end
+  if(ctx->dead) {
+    if(depth >= ctx->dead) return JSON_OK;
+    ctx->dead = 0;
+  }
+
+  if(type == JSON_KEY) {
+    json_path_advance(ctx, depth, (json_string *)value, 0);
+  } else if(type == JSON_OBJECT_END || type == JSON_ARRAY_END) {
+    for(q = 0; q < ctx->queries; q++) {
+      if(ctx->within[q] && depth + 1 >= ctx->within[q]) {
+        if(depth + 1 == ctx->within[q]) ctx->within[q] = 0;
+        error = ctx->callback(q, depth, type, value, ctx->user);
+        if(error) return error;
+      }
+    }
+    return JSON_OK;
+  } else {
+    // Value, in array elements get their position here (object members got theirs from key)
+    if(depth && !(ctx->object[(depth - 1) >> 3] & (1 << ((depth - 1) & 0x07)))) json_path_advance(ctx, depth, NULL, ctx->index[depth]++);
+    if(type == JSON_OBJECT || type == JSON_ARRAY) {
+      if(type == JSON_OBJECT) ctx->object[depth >> 3] |= 1 << (depth & 0x07);
+      else ctx->object[depth >> 3] &= ~(1 << (depth & 0x07));
+      if(depth < JSON_NESTING) ctx->index[depth + 1] = 0;
+      for(q = 0; q < ctx->queries && !ctx->active[depth][q] && !ctx->within[q]; q++);
+      if(q == ctx->queries) ctx->dead = depth + 1;
+    }
+  }
+
+  for(q = 0; q < ctx->queries; q++) {
+    if(ctx->within[q]) {
+      if(depth + 1 <= ctx->within[q]) continue;
+    } else {
+      if(type == JSON_KEY || !(ctx->active[depth][q] & (1UL << ctx->steps[q]))) continue;
+      if(type == JSON_OBJECT || type == JSON_ARRAY) ctx->within[q] = depth + 1;
+    }
+    error = ctx->callback(q, depth, type, value, ctx->user);
+    if(error) return error;
+  }
+  return JSON_OK;
+}
@@ -0,0 +1,51 @@
+#ifndef JSON_PATH_H
+#define JSON_PATH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "json.h"
+
+// JSON path configuration
+#define JSON_PATH_QUERIES         8 // Max number of queries compiled together
+#define JSON_PATH_STEPS          15 // Max steps per query (max 31)
+
+// JSON path step types
+#define JSON_PATH_KEY             0 // .name or ['name']
+#define JSON_PATH_ANY_KEY         1 // .*
+#define JSON_PATH_INDEX           2 // [n]
+#define JSON_PATH_ANY_INDEX       3 // [*]
+#define JSON_PATH_DESCENDANT   0x80 // Flag for steps preceded by .. (matches at any depth below)
+
+// JSON path match callback (query is index into the compiled query list)
+typedef uint8_t (*json_path_cb)(uint8_t query, uint32_t depth, uint8_t type, void * value, void * user);
+
+typedef struct {
+  const char * key;
+  uint32_t index; // Array index, or key length
+  uint8_t type;
+} json_path_step;
+
+typedef struct {
+  json_path_cb callback;
+  void * user;
+  uint8_t queries;
+  uint8_t steps[JSON_PATH_QUERIES];
+  json_path_step step[JSON_PATH_QUERIES][JSON_PATH_STEPS];
+  uint32_t active[JSON_NESTING + 1][JSON_PATH_QUERIES]; // Bit n: value at depth matched first n steps
+  uint32_t index[JSON_NESTING + 1];                     // Index of next element at depth
+  uint8_t object[(JSON_NESTING + 8) / 8];               // Container at depth is an object (also at JSON_NESTING, delivered before JSON_TOO_DEEP)
+  uint16_t within[JSON_PATH_QUERIES];                   // Depth + 1 of matched container being delivered
+  uint32_t dead;                                        // Depth + 1 of container no query can match within
+} json_path_ctx;
+
+// JSON path compile queries
+// * Supports $ followed by .name ['name'] .* [n] [*] and .. before any of them
+// * Query strings are referenced, not copied, and must stay available while parsing
+// * Returns JSON_BAD_PATH if a query is malformed or exceeds configured limits
+uint8_t json_path_compile(json_path_ctx * ctx, const char * const * queries, uint8_t count, json_path_cb callback, void * user);
+
+// JSON path parsing callback (pass with compiled json_path_ctx as user)
+// * Matching values are delivered with their query, matching objects and arrays with all their contents
+uint8_t json_path_callback(uint32_t depth, uint8_t type, void * value, void * user);
+
+#endif
@@ -6,6 +6,18 @@
 // Base64 alphabet
 const char base64lut[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
+// Base64 alphabet values by character (inverse of base64lut, 0xFF if not in alphabet)
+static const uint8_t base64inv[128] = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x00
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x10
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F, // 0x20
+  0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x30
+  0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, // 0x40
+  0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, // 0x50
+  0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, // 0x60
+  0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF // 0x70
+};
+
 // Latin-1 to UTF8 conversion
 size_t latin1_to_utf8(char *out, size_t out_n, char *inp, size_t inp_n) {
   uint8_t l;
@@ -102,25 +114,25 @@ size_t octets_to_base64(char *out, size_t out_n, char *inp, size_t inp_n) {
   return ret_n;
 }
 
+// Return value of Base-64 character
+uint8_t base64_value(char c) {
+  return (uint8_t)c < 0x80 ? base64inv[(uint8_t)c] : 0xFF;
+}
+
 // Convert Base-64 to octets
 size_t base64_to_octets(char *out, size_t out_n, char *inp, size_t inp_n) {
   uint8_t block[4], n = 0;
-  char *p_dec;
   size_t ret_n = 0;
   // Make sure output is available (1 byte will always be written)
   if(out_n == 0) return 0;
   // Iterate over data
   while(inp_n--) {
 #ifdef B64_ERROR_CHECK
-    if(!(p_dec = memchr(base64lut, *inp++, 64))) break;
-    block[n++] = p_dec - base64lut;
+    if((block[n] = base64_value(*inp++)) > 63) break;
+    n++;
 #else
     if(*inp == '=') break;
-    else if(*inp < 0x30) block[n] = 62 + ((*inp - '+') >> 2);
-    else if(*inp < 0x40) block[n] = 52 + (*inp - '0');
-    else if(*inp < 0x60) block[n] = (*inp - 'A');
-    else block[n] = 26 + (*inp - 'a');
-    inp++;
+    block[n] = base64inv[*inp++ & 0x7F];
     n++;
 #endif
     // When four bytes have been read, decode block
@@ -29,6 +29,9 @@ size_t utf8_to_latin1(char *out, size_t out_n, char *inp, size_t inp_n);
 // * Stops if output size (out_n) exceeded
 size_t octets_to_base64(char *out, size_t out_n, char *inp, size_t inp_n);
 
+// Return value (0-63) of Base-64 character, 0xFF if not in alphabet
+uint8_t base64_value(char c);
+
 // Convert Base-64 to octets
 // * Does not require padding
 // * Allows in place conversion (out == in)
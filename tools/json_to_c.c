@@ -0,0 +1,162 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "json.h"
+
+// Converts a JSON document into C source holding its parsed events, so that
+// embedded documents are validated at build time and cost no parsing at run
+// time: json_replay(name, name_count, callback, user) delivers the same
+// callbacks as json_parse would have.
+//
+// Build:  gcc -std=c99 -O2 -I.. json_to_c.c ../json.c -lm -o json_to_c
+// Usage:  json_to_c <file.json> <name> > file.c
+// Declare: extern const json_event name[]; extern const size_t name_count;
+//
+// * Build with the same json.h configuration as the code using the output
+// * Strings are placed in constant memory, callbacks must not modify them
+// * Malformed input is reported with its offset and exits with an error
+// * Only the event stream is generated, binding events to C structs is left to the callback
+
+typedef struct {
+  uint32_t depth;
+  uint8_t type;
+  size_t text, text_end; // Position in text pool (strings, raw numbers)
+  json_number n;
+} record;
+
+static record *records;
+static size_t record_count, record_size;
+static uint8_t *pool;
+static size_t pool_length, pool_size;
+
+// Add octets to text pool, returns position
+static size_t pool_add(const uint8_t *data, size_t length) {
+  size_t at = pool_length;
+  while(pool_length + length + 1 > pool_size) {
+    pool_size = pool_size ? pool_size * 2 : 1024;
+    pool = realloc(pool, pool_size);
+    if(!pool) exit(2);
+  }
+  memcpy(&pool[pool_length], data, length);
+  pool_length += length;
+  pool[pool_length++] = 0;
+  return at;
+}
+
+// Callback recording events
+static uint8_t record_json(uint32_t depth, uint8_t type, void * value, void * user) {
+  record *r;
+  (void)user;
+  if(record_count == record_size) {
+    record_size = record_size ? record_size * 2 : 256;
+    records = realloc(records, record_size * sizeof(record));
+    if(!records) exit(2);
+  }
+  r = &records[record_count++];
+  memset(r, 0, sizeof(record));
+  r->depth = depth;
+  r->type = type;
+  if(type == JSON_KEY || type == JSON_STRING) {
+    json_string *s = (json_string *)value;
+    r->text = pool_add(s->string, s->string_end - s->string);
+    r->text_end = r->text + (s->string_end - s->string);
+  } else if(type == JSON_NUMBER) {
+    r->n = *(json_number *)value;
+#ifdef JSON_RAW_NUMBERS
+    r->text = pool_add(r->n.string, r->n.string_end - r->n.string);
+    r->text_end = r->text + (r->n.string_end - r->n.string);
+#endif
+  }
+  return JSON_OK;
+}
+
+static const char * type_name(uint8_t type) {
+  switch(type) {
+    case JSON_OBJECT:     return "JSON_OBJECT";
+    case JSON_OBJECT_END: return "JSON_OBJECT_END";
+    case JSON_ARRAY:      return "JSON_ARRAY";
+    case JSON_ARRAY_END:  return "JSON_ARRAY_END";
+    case JSON_KEY:        return "JSON_KEY";
+    case JSON_STRING:     return "JSON_STRING";
+    case JSON_NUMBER:     return "JSON_NUMBER";
+    case JSON_NULL:       return "JSON_NULL";
+    case JSON_TRUE:       return "JSON_TRUE";
+    case JSON_FALSE:      return "JSON_FALSE";
+  }
+  return "JSON_CONSTANT";
+}
+
+// Print text pool as string literal
+static void print_pool(const char *name) {
+  size_t n, column = 0;
+  printf("static const uint8_t %s_text[] =\n  \"", name);
+  for(n = 0; n < pool_length; n++) {
+    uint8_t c = pool[n];
+    if(c >= 0x20 && c < 0x7F && c != '"' && c != '\\' && c != '?') {
+      putchar(c);
+      column++;
+    } else {
+      printf("\\%03o", c);
+      column += 4;
+    }
+    if(column >= 76 && n + 1 < pool_length) {
+      printf("\"\n  \"");
+      column = 0;
+    }
+  }
+  printf("\";\n\n");
+}
+
+int main(int argc, char **argv) {
+  static char jsbuf[0xFFFF];
+  FILE *f;
+  int q;
+  size_t offset = 0, n;
+  uint8_t result = JSON_OK;
+  json_parser_ctx ctx = json_stream(jsbuf, sizeof(jsbuf), record_json, NULL);
+
+  if(argc != 3) {
+    fprintf(stderr, "Usage: %s <file.json> <name>\n", argv[0]);
+    return 1;
+  }
+  f = fopen(argv[1], "rb");
+  if(!f) {
+    fprintf(stderr, "%s: cannot open\n", argv[1]);
+    return 1;
+  }
+  while((q = fgetc(f)) != EOF) {
+    result = json_octet(&ctx, (uint8_t)q);
+    if(result) break;
+    offset++;
+  }
+  fclose(f);
+  if(!result) result = json_octet(&ctx, ' '); // Terminate "lonely" values
+  if(!result && !json_eof(&ctx)) result = JSON_UNEXPECTED_END;
+  if(result) {
+    fprintf(stderr, "%s:%lu: error: JSON error %u\n", argv[1], (unsigned long)offset, result);
+    return 1;
+  }
+
+  printf("// Generated by json_to_c from %s, do not edit\n", argv[1]);
+  printf("#include <stdint.h>\n#include <stdbool.h>\n#include <stddef.h>\n#include \"json.h\"\n\n");
+  if(pool_length) print_pool(argv[2]);
+  printf("const json_event %s[] = {\n", argv[2]);
+  for(n = 0; n < record_count; n++) {
+    record *r = &records[n];
+    printf("  {%lu, %s", (unsigned long)r->depth, type_name(r->type));
+    if(r->type == JSON_KEY || r->type == JSON_STRING) {
+      printf(", {.s = {(uint8_t *)%s_text + %lu, (uint8_t *)%s_text + %lu}}", argv[2], (unsigned long)r->text, argv[2], (unsigned long)r->text_end);
+    } else if(r->type == JSON_NUMBER) {
+#ifdef JSON_RAW_NUMBERS
+      printf(", {.n = {(uint8_t *)%s_text + %lu, (uint8_t *)%s_text + %lu, %u}}", argv[2], (unsigned long)r->text, argv[2], (unsigned long)r->text_end, r->n.flags);
+#else
+      printf(", {.n = {.number = %lu, .exponent = %u, .zero = %u, .decimals = %u, .flags = %u}}", (unsigned long)r->n.number, (unsigned)r->n.exponent, r->n.zero, r->n.decimals, r->n.flags);
+#endif
+    }
+    printf("},\n");
+  }
+  printf("};\n\nconst size_t %s_count = %lu;\n", argv[2], (unsigned long)record_count);
+  return 0;
+}
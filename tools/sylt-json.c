@@ -0,0 +1,452 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "json.h"
+#include "json_image.h"
+#include "helpers.h"
+
+// Validates, minifies, gathers statistics for or snapshots many JSON / NDJSON files in parallel
+//
+// Build:  gcc -std=c99 -O2 -DJSON_RAW_NUMBERS -I.. -I../examples sylt-json.c ../json.c ../json_image.c -lm -lpthread -o sylt-json
+// Usage:  sylt-json [-m validate|minify|stats|snapshot] [-j threads] [-n] [-q] <file|directory>...
+//   -m  Mode (default validate), minify writes documents to stdout one per line,
+//       snapshot writes each file as binary image (json_image.h) to <file>.img,
+//       images use 32-bit offsets so documents that need 4 GiB or more fail with IMAGE OVERFLOW
+//   -j  Worker threads (default: online processors)
+//   -n  Treat all files as NDJSON (default for *.ndjson and *.jsonl), empty lines are skipped,
+//       not with snapshot which takes every file as one document
+//   -q  Report only files with errors (and the summary)
+//
+// * Directories are searched recursively for *.json, *.ndjson and *.jsonl
+// * Reports one JSON object per file in argument order, then a summary object
+//   (to stdout, or to stderr when minifying), error offsets are byte offsets in the file
+// * Files are memory mapped copy-on-write and parsed in place, NDJSON is split into
+//   chunks at line boundaries so a single large file also uses all threads
+// * Limits (nesting depth, number sizes) follow json.h configuration,
+//   JSON_RAW_NUMBERS validates numbers of any size
+// * Exit status: 0 all valid, 1 invalid or unreadable files found, 2 usage error
+
+#define MODE_VALIDATE 0
+#define MODE_MINIFY   1
+#define MODE_STATS    2
+#define MODE_SNAPSHOT 3
+
+#define CHUNK_SIZE (4 << 20) // NDJSON octets per job
+
+typedef struct {
+  char *data;
+  size_t length, size;
+} output;
+
+typedef struct {
+  uint64_t documents, invalid;
+  uint64_t error_offset; // First error (lowest offset)
+  uint8_t error;
+  uint32_t depth;
+  uint64_t events[JSON_FALSE + 1];
+  uint64_t image_size;
+} result;
+
+typedef struct {
+  char *path;
+  uint64_t size;
+  bool ndjson, missing, unreadable, unwritable;
+  uint32_t first_job, jobs, pending;
+  result r;
+} file_entry;
+
+typedef struct {
+  uint32_t file;
+  uint64_t start, end;
+  bool unreadable, unwritable;
+  output out;
+  result r;
+} job;
+
+static uint8_t mode = MODE_VALIDATE;
+static bool all_ndjson, quiet;
+static FILE *report;
+
+static file_entry *files;
+static uint32_t file_count, file_size;
+static job *jobs;
+static uint32_t job_count, job_next, file_next;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Append octets to output
+static void output_add(output *o, const char *data, size_t length) {
+  if(o->length + length > o->size) {
+    o->size = (o->length + length) * 2;
+    o->data = realloc(o->data, o->size);
+    if(!o->data) exit(2);
+  }
+  memcpy(&o->data[o->length], data, length);
+  o->length += length;
+}
+
+// Append document without white-space outside strings
+static void output_minified(output *o, const char *data, size_t length) {
+  size_t n;
+  bool string = false, escape = false;
+  if(o->length + length + 1 > o->size) {
+    o->size = (o->length + length + 1) * 2;
+    o->data = realloc(o->data, o->size);
+    if(!o->data) exit(2);
+  }
+  for(n = 0; n < length; n++) {
+    char q = data[n];
+    if(string) {
+      if(escape) escape = false;
+      else if(q == '\\') escape = true;
+      else if(q == '"') string = false;
+    } else if(q == ' ' || q == '\t' || q == '\n' || q == '\r') {
+      continue;
+    } else if(q == '"') string = true;
+    o->data[o->length++] = q;
+  }
+}
+
+// Print string as JSON string
+static void print_string(FILE *f, const char *s) {
+  fputc('"', f);
+  for(; *s; s++) {
+    if(*s == '"' || *s == '\\') fprintf(f, "\\%c", *s);
+    else if((uint8_t)*s < 0x20) fprintf(f, "\\u%04x", *s);
+    else fputc(*s, f);
+  }
+  fputc('"', f);
+}
+
+// Callback counting events for statistics
+static uint8_t count_event(uint32_t depth, uint8_t type, void * value, void * user) {
+  result *r = (result *)user;
+  (void)value;
+  r->events[type]++;
+  if((type == JSON_OBJECT || type == JSON_ARRAY) && depth + 1 > r->depth) r->depth = depth + 1;
+  return JSON_OK;
+}
+
+// Parse document in place, offset receives position of error
+static uint8_t parse(char *data, size_t length, size_t *offset, json_cb callback, void * user) {
+  json_parser_ctx ctx = {callback, user, (uint8_t *)data};
+  uint8_t error = JSON_OK;
+  size_t n;
+  for(n = 0; n < length; n++, ctx.buffer++) {
+    error = json_octet(&ctx, *ctx.buffer);
+    if(error) break;
+  }
+  if(!error) error = json_octet(&ctx, ' '); // Terminate "lonely" values
+  if(!error && !json_eof(&ctx)) error = JSON_UNEXPECTED_END;
+  *offset = n;
+  return error;
+}
+
+// Read document again from start of file (in-place parsing changes it)
+static bool reload(const char *path, char *data, size_t length) {
+  size_t n = 0;
+  ssize_t r = 1;
+  int fd = open(path, O_RDONLY);
+  if(fd < 0) return false;
+  while(n < length && r > 0) {
+    r = pread(fd, &data[n], length - n, n);
+    if(r > 0) n += r;
+  }
+  close(fd);
+  return n == length;
+}
+
+// Convert document to image file next to it
+// * Image and scratch stack start small and are doubled on JSON_IMAGE_OVERFLOW, the image up to its 4 GiB limit
+static uint8_t snapshot(job *j, char *data, size_t length, size_t *offset) {
+  json_image_builder builder;
+  uint64_t size = (uint64_t)length * 2 + 64;
+  uint64_t stack_size = length / 8 + 16, stack_max = (uint64_t)length + 2; // At most one entry per octet
+  uint32_t *image = NULL, *stack = NULL;
+  char *path;
+  FILE *f;
+  uint8_t error = JSON_IMAGE_OVERFLOW;
+  if(stack_max > 0xFFFFFFFF) stack_max = 0xFFFFFFFF;
+  path = malloc(strlen(files[j->file].path) + 5);
+  while(path) {
+    if(size > 0xFFFFFFFC) size = 0xFFFFFFFC;
+    if(stack_size > stack_max) stack_size = stack_max;
+    free(image);
+    free(stack);
+    image = malloc(size);
+    stack = malloc(stack_size * sizeof(uint32_t));
+    if(!image || !stack) break;
+    json_image_begin(&builder, image, size, stack, stack_size);
+    error = parse(data, length, offset, json_image_callback, &builder);
+    if(!error) error = json_image_end(&builder);
+    if(error != JSON_IMAGE_OVERFLOW) break;
+    if(builder.stack_used == builder.stack_size && stack_size < stack_max) stack_size *= 2;
+    else if(size < 0xFFFFFFFC) size *= 2;
+    else break;
+    if(!reload(files[j->file].path, data, length)) {
+      j->unreadable = true;
+      break;
+    }
+  }
+  if(!error) {
+    sprintf(path, "%s.img", files[j->file].path);
+    f = fopen(path, "wb");
+    if(!f || fwrite(image, 1, builder.used, f) != builder.used) j->unwritable = true;
+    if(f && fclose(f)) j->unwritable = true;
+    j->r.image_size += builder.used;
+  }
+  free(image);
+  free(stack);
+  free(path);
+  return error;
+}
+
+// Check document at file offset base, collecting results in job
+static void run_document(job *j, char *data, size_t length, uint64_t base) {
+  size_t offset, restore = j->out.length;
+  uint8_t error;
+  if(mode == MODE_MINIFY) output_minified(&j->out, data, length);
+  if(mode == MODE_SNAPSHOT) error = snapshot(j, data, length, &offset);
+  else error = parse(data, length, &offset, mode == MODE_STATS ? count_event : NULL, &j->r);
+  j->r.documents++;
+  if(error) {
+    if(!j->r.invalid++) {
+      j->r.error = error;
+      j->r.error_offset = base + offset;
+    }
+    j->out.length = restore;
+  } else if(mode == MODE_MINIFY) {
+    output_add(&j->out, "\n", 1);
+  }
+}
+
+// Check file or NDJSON chunk (lines starting within chunk)
+static void run_job(job *j) {
+  file_entry *f = &files[j->file];
+  uint64_t p, e, n;
+  char *data, *q;
+  long page = sysconf(_SC_PAGESIZE);
+  int fd;
+  if(f->missing) return;
+  if(f->size == 0) {
+    if(!f->ndjson) run_document(j, "", 0, 0);
+    return;
+  }
+  fd = open(f->path, O_RDONLY);
+  if(fd < 0) {
+    j->unreadable = true;
+    return;
+  }
+  data = mmap(NULL, f->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(data == MAP_FAILED) {
+    j->unreadable = true;
+    return;
+  }
+  p = page > 0 ? j->start - j->start % page : j->start; // Advice starts at a page boundary
+  posix_madvise(data + p, j->end - p, POSIX_MADV_SEQUENTIAL);
+  if(f->ndjson) {
+    p = j->start;
+    if(p > 0 && data[p - 1] != '\n') {
+      q = memchr(&data[p], '\n', f->size - p);
+      p = q ? (uint64_t)(q - data) + 1 : f->size;
+    }
+    while(p < j->end) {
+      q = memchr(&data[p], '\n', f->size - p);
+      e = q ? (uint64_t)(q - data) : f->size;
+      n = (e > p && data[e - 1] == '\r') ? e - 1 : e;
+      if(n > p) run_document(j, &data[p], n - p, p);
+      p = e + 1;
+    }
+  } else {
+    run_document(j, data, f->size, 0);
+  }
+  munmap(data, f->size);
+}
+
+// Print report for file
+static void print_file(file_entry *f) {
+  uint32_t n;
+  if(mode == MODE_MINIFY) {
+    for(n = f->first_job; n < f->first_job + f->jobs; n++) {
+      fwrite(jobs[n].out.data, 1, jobs[n].out.length, stdout);
+      free(jobs[n].out.data);
+      jobs[n].out.data = NULL;
+    }
+  }
+  if(quiet && !f->r.invalid && !f->unreadable && !f->unwritable) return;
+  fprintf(report, "{\"file\":");
+  print_string(report, f->path);
+  fprintf(report, ",\"bytes\":%llu,\"documents\":%llu,\"invalid\":%llu", (unsigned long long)f->size, (unsigned long long)f->r.documents, (unsigned long long)f->r.invalid);
+  if(f->unreadable) {
+    fprintf(report, ",\"error\":\"UNREADABLE\"");
+  } else if(f->unwritable) {
+    fprintf(report, ",\"error\":\"UNWRITABLE\"");
+  } else if(f->r.invalid) {
+    fprintf(report, ",\"error\":\"%s\",\"code\":%u,\"offset\":%llu", result_to_string(f->r.error), f->r.error, (unsigned long long)f->r.error_offset);
+  }
+  if(mode == MODE_STATS) {
+    fprintf(report, ",\"depth\":%u,\"objects\":%llu,\"arrays\":%llu,\"keys\":%llu,\"strings\":%llu,\"numbers\":%llu,\"constants\":%llu", f->r.depth,
+      (unsigned long long)f->r.events[JSON_OBJECT], (unsigned long long)f->r.events[JSON_ARRAY], (unsigned long long)f->r.events[JSON_KEY],
+      (unsigned long long)f->r.events[JSON_STRING], (unsigned long long)f->r.events[JSON_NUMBER],
+      (unsigned long long)(f->r.events[JSON_NULL] + f->r.events[JSON_TRUE] + f->r.events[JSON_FALSE]));
+  }
+  if(mode == MODE_SNAPSHOT) fprintf(report, ",\"image_bytes\":%llu", (unsigned long long)f->r.image_size);
+  fprintf(report, "}\n");
+}
+
+// Add job results to its file, print files completed in argument order (lock held)
+static void finish_job(job *j) {
+  file_entry *f = &files[j->file];
+  uint8_t n;
+  if(j->r.invalid && (!f->r.invalid || j->r.error_offset < f->r.error_offset)) {
+    f->r.error = j->r.error;
+    f->r.error_offset = j->r.error_offset;
+  }
+  f->r.documents += j->r.documents;
+  f->r.invalid += j->r.invalid;
+  if(j->r.depth > f->r.depth) f->r.depth = j->r.depth;
+  for(n = 0; n <= JSON_FALSE; n++) f->r.events[n] += j->r.events[n];
+  f->unreadable |= j->unreadable;
+  f->unwritable |= j->unwritable;
+  f->r.image_size += j->r.image_size;
+  f->pending--;
+  while(file_next < file_count && !files[file_next].pending) print_file(&files[file_next++]);
+}
+
+// Worker thread, takes next job until none are left
+static void *worker(void *arg) {
+  uint32_t n;
+  (void)arg;
+  for(;;) {
+    pthread_mutex_lock(&lock);
+    n = job_next++;
+    pthread_mutex_unlock(&lock);
+    if(n >= job_count) return NULL;
+    run_job(&jobs[n]);
+    pthread_mutex_lock(&lock);
+    finish_job(&jobs[n]);
+    pthread_mutex_unlock(&lock);
+  }
+}
+
+// Check file name extension
+static bool has_extension(const char *path, const char *extension) {
+  size_t length = strlen(path), extension_length = strlen(extension);
+  return length > extension_length && !strcmp(&path[length - extension_length], extension);
+}
+
+// Add file, or JSON files found in directory
+static void add_path(const char *path, bool listed) {
+  struct stat st;
+  file_entry *f;
+  bool missing = (listed ? stat(path, &st) : lstat(path, &st)) < 0;
+  if(missing) {
+    if(!listed) return;
+    memset(&st, 0, sizeof(st));
+    st.st_mode = S_IFREG; // Reported as unreadable
+  }
+  if(S_ISDIR(st.st_mode)) {
+    struct dirent *de;
+    DIR *dr = opendir(path);
+    if(!dr) return;
+    while((de = readdir(dr))) {
+      char *sub;
+      if(!strcmp(de->d_name, ".") || !strcmp(de->d_name, "..")) continue;
+      sub = malloc(strlen(path) + strlen(de->d_name) + 2);
+      if(!sub) exit(2);
+      sprintf(sub, "%s/%s", path, de->d_name);
+      add_path(sub, false);
+      free(sub);
+    }
+    closedir(dr);
+    return;
+  }
+  if(!S_ISREG(st.st_mode)) return;
+  if(!listed && !has_extension(path, ".json") && !has_extension(path, ".ndjson") && !has_extension(path, ".jsonl")) return;
+  if(file_count == file_size) {
+    file_size = file_size ? file_size * 2 : 256;
+    files = realloc(files, file_size * sizeof(file_entry));
+    if(!files) exit(2);
+  }
+  f = &files[file_count++];
+  memset(f, 0, sizeof(file_entry));
+  f->path = strdup(path);
+  f->size = st.st_size;
+  f->unreadable = f->missing = missing;
+  f->ndjson = mode != MODE_SNAPSHOT && (all_ndjson || has_extension(path, ".ndjson") || has_extension(path, ".jsonl"));
+  f->jobs = f->ndjson && f->size > CHUNK_SIZE ? (f->size + CHUNK_SIZE - 1) / CHUNK_SIZE : 1;
+  job_count += f->jobs;
+}
+
+int main(int argc, char **argv) {
+  struct timespec t0, t1;
+  pthread_t *threads;
+  long thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+  uint64_t bytes = 0, documents = 0, invalid = 0;
+  uint32_t n, k, j = 0;
+  int opt;
+
+  while((opt = getopt(argc, argv, "m:j:nq")) != -1) {
+    if(opt == 'm' && !strcmp(optarg, "validate")) mode = MODE_VALIDATE;
+    else if(opt == 'm' && !strcmp(optarg, "minify")) mode = MODE_MINIFY;
+    else if(opt == 'm' && !strcmp(optarg, "stats")) mode = MODE_STATS;
+    else if(opt == 'm' && !strcmp(optarg, "snapshot")) mode = MODE_SNAPSHOT;
+    else if(opt == 'j' && atol(optarg) > 0) thread_count = atol(optarg);
+    else if(opt == 'n') all_ndjson = true;
+    else if(opt == 'q') quiet = true;
+    else optind = argc + 1;
+  }
+  if(optind >= argc) {
+    fprintf(stderr, "Usage: %s [-m validate|minify|stats|snapshot] [-j threads] [-n] [-q] <file|directory>...\n", argv[0]);
+    return 2;
+  }
+  if(thread_count < 1) thread_count = 1;
+  report = mode == MODE_MINIFY ? stderr : stdout;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  // Collect files and split them into jobs
+  for(; optind < argc; optind++) add_path(argv[optind], true);
+  jobs = calloc(job_count ? job_count : 1, sizeof(job));
+  if(!jobs) return 2;
+  for(n = 0; n < file_count; n++) {
+    files[n].first_job = j;
+    files[n].pending = files[n].jobs;
+    for(k = 0; k < files[n].jobs; k++, j++) {
+      jobs[j].file = n;
+      jobs[j].start = (uint64_t)k * CHUNK_SIZE;
+      jobs[j].end = k + 1 == files[n].jobs ? files[n].size : (uint64_t)(k + 1) * CHUNK_SIZE;
+    }
+  }
+
+  // Run workers
+  if(thread_count > job_count) thread_count = job_count ? job_count : 1;
+  threads = malloc(thread_count * sizeof(pthread_t));
+  if(!threads) return 2;
+  for(n = 0; n < thread_count && !pthread_create(&threads[n], NULL, worker, NULL); n++);
+  if(n == 0) worker(NULL); // No thread could be started, jobs are run here (else started threads take them all)
+  for(k = 0; k < n; k++) pthread_join(threads[k], NULL);
+  free(threads);
+  thread_count = n ? n : 1;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  // Summary
+  for(n = 0; n < file_count; n++) {
+    bytes += files[n].size;
+    documents += files[n].r.documents;
+    if(files[n].r.invalid || files[n].unreadable || files[n].unwritable) invalid++;
+  }
+  fprintf(report, "{\"files\":%u,\"invalid_files\":%llu,\"bytes\":%llu,\"documents\":%llu,\"threads\":%ld,\"seconds\":%.3f}\n",
+    file_count, (unsigned long long)invalid, (unsigned long long)bytes, (unsigned long long)documents, thread_count,
+    (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+  return invalid ? 1 : 0;
+}